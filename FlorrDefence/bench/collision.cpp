@@ -0,0 +1,203 @@
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <format>
+#include <chrono>
+#include <random>
+#include <numbers>
+#include <algorithm>
+#include "AssetManager.hpp"
+#include "SpriteCollisionManager.hpp"
+#include "Constants.hpp"
+
+// Times SpriteCollisionManager::isCollide alone, on pairs built once up front from the real
+// textures, so changes to the sampling heuristic can be compared without the rest of a tick
+
+enum class Placement {
+    Overlapping,  // Petal center well inside the mob
+    NearMiss      // Around the distance where the outlines start to touch
+};
+
+struct PairClass {
+    std::string target;   // "common_mob" or "super_boss"
+    float mobScale;
+    float scale;          // Multiplies both sprites
+    bool rotated;
+    Placement placement;
+
+    std::string getName() const {
+        return std::format("{}/x{}/{}/{}", target, scale, rotated ? "rotated" : "axis_aligned",
+            placement == Placement::Overlapping ? "overlapping" : "near_miss");
+    }
+};
+
+struct PairResult {
+    std::string name;
+    int64_t tests = 0;
+    double nsPerTest = 0.0;
+    double hitRate = 0.0;
+};
+
+static std::vector<const TexRegion*> getRegions(const std::string& group) {
+    // Sorted by name, the texture map is unordered and runs must be repeatable
+    const TexEntry& entry = AssetManager::getEntry().get(group);
+    std::vector<std::pair<std::string, const TexRegion*>> named;
+    for (const auto& [name, sub] : entry.subs)
+        if (sub->isTexture)
+            named.emplace_back(name, &sub->region);
+    std::sort(named.begin(), named.end());
+
+    std::vector<const TexRegion*> regions;
+    for (const auto& [_, region] : named)
+        regions.push_back(region);
+    return regions;
+}
+
+static sf::Sprite makeSprite(const TexRegion& region, float scale, sf::Angle rotation, sf::Vector2f position) {
+    sf::Sprite sprite(region.getTexture(), region.rect);
+    sprite.setOrigin(sf::Vector2f(region.rect.size) / 2.f);
+    sprite.setScale({ scale, scale });
+    sprite.setRotation(rotation);
+    sprite.setPosition(position);
+    return sprite;
+}
+
+static float getRadius(const sf::Sprite& sprite) {
+    sf::FloatRect bounds = SpriteCollisionManager::getTrimmedBounds(sprite);
+    return (bounds.size.x + bounds.size.y) / 4.f;
+}
+
+static std::vector<std::pair<sf::Sprite, sf::Sprite>> buildPairs(const PairClass& pairClass, size_t count, uint32_t seed,
+                                                                  const std::vector<const TexRegion*>& petals,
+                                                                  const std::vector<const TexRegion*>& mobs) {
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> unit(0.f, 1.f);
+    auto randomAngle = [&]() { return pairClass.rotated ? sf::degrees(unit(rng) * 360.f) : sf::Angle::Zero; };
+
+    std::vector<std::pair<sf::Sprite, sf::Sprite>> pairs;
+    pairs.reserve(count);
+
+    for (size_t i = 0; i < count; i++) {
+        const TexRegion& petalRegion = *petals[i % petals.size()];
+        const TexRegion& mobRegion = *mobs[(i / petals.size() + i) % mobs.size()];
+
+        sf::Sprite mob = makeSprite(mobRegion, pairClass.mobScale * pairClass.scale, randomAngle(), { 500.f, 500.f });
+        sf::Sprite petal = makeSprite(petalRegion, 0.32f * pairClass.scale, randomAngle(), { 500.f, 500.f });
+
+        sf::Angle direction = sf::radians(unit(rng) * 2.f * std::numbers::pi_v<float>);
+        float distance = pairClass.placement == Placement::Overlapping
+            ? getRadius(mob) * 0.3f * unit(rng)
+            : (getRadius(mob) + getRadius(petal)) * (0.85f + 0.25f * unit(rng));
+        petal.move(sf::Vector2f(distance, direction));
+
+        pairs.emplace_back(std::move(petal), std::move(mob));
+    }
+
+    return pairs;
+}
+
+static PairResult run(const PairClass& pairClass, const std::vector<std::pair<sf::Sprite, sf::Sprite>>& pairs, double minSeconds) {
+    using Clock = std::chrono::steady_clock;
+
+    int64_t hits = 0;
+    auto pass = [&]() {
+        for (const auto& [a, b] : pairs)
+            hits += SpriteCollisionManager::isCollide(a, b);
+    };
+
+    // Warm-up, also counts the hits of one pass
+    pass();
+    int64_t passHits = hits;
+
+    int64_t passes = 0;
+    Clock::time_point start = Clock::now();
+    std::chrono::duration<double> elapsed{};
+    do {
+        pass();
+        passes++;
+        elapsed = Clock::now() - start;
+    } while (elapsed.count() < minSeconds);
+
+    PairResult result;
+    result.name = pairClass.getName();
+    result.tests = passes * (int64_t)pairs.size();
+    result.nsPerTest = elapsed.count() * 1e9 / result.tests;
+    result.hitRate = (double)passHits / pairs.size();
+    return result;
+}
+
+// Usage: FlorrDefenceCollisionBench [--pairs N] [--seconds S] [--seed N] [--only SUBSTRING] [--json PATH]
+int main(int argc, char* argv[]) {
+    size_t pairCount = 4096;
+    double minSeconds = 0.25;
+    uint32_t seed = 1;
+    std::string only;
+    std::string jsonPath;
+
+    for (int i = 1; i + 1 < argc; i += 2) {
+        std::string arg = argv[i];
+        if (arg == "--pairs")
+            pairCount = std::stoul(argv[i + 1]);
+        else if (arg == "--seconds")
+            minSeconds = std::stod(argv[i + 1]);
+        else if (arg == "--seed")
+            seed = (uint32_t)std::stoul(argv[i + 1]);
+        else if (arg == "--only")
+            only = argv[i + 1];
+        else if (arg == "--json")
+            jsonPath = argv[i + 1];
+        else {
+            std::cerr << "Unknown argument: " << arg << std::endl;
+            return -1;
+        }
+    }
+
+    std::cout << "--- Florr Defence (collision bench) ---" << std::endl;
+    loadConstants();
+    AssetManager::load();
+    SpriteCollisionManager::load();
+
+    std::vector<const TexRegion*> petals = getRegions("petals");
+    std::vector<const TexRegion*> mobs = getRegions("mobs");
+
+    std::vector<PairClass> classes;
+    for (auto [target, mobScale] : { std::pair{ "common_mob", MOB_RARITY_SCALES.at("common") },
+                                     std::pair{ "super_boss", MOB_RARITY_SCALES.at("super") } })
+        for (float scale : { 0.5f, 1.f, 2.f })
+            for (bool rotated : { false, true })
+                for (Placement placement : { Placement::Overlapping, Placement::NearMiss })
+                    classes.push_back({ target, mobScale, scale, rotated, placement });
+
+    std::cout << std::format("{:<48} {:>10} {:>9}", "pair class", "ns/test", "hit rate") << std::endl;
+
+    nlohmann::json report = nlohmann::json::array();
+    double totalNs = 0.0;
+    for (const PairClass& pairClass : classes) {
+        if (!only.empty() && pairClass.getName().find(only) == std::string::npos)
+            continue;
+
+        auto pairs = buildPairs(pairClass, pairCount, seed, petals, mobs);
+        PairResult r = run(pairClass, pairs, minSeconds);
+        totalNs += r.nsPerTest;
+
+        std::cout << std::format("{:<48} {:>10.1f} {:>8.1f}%", r.name, r.nsPerTest, r.hitRate * 100.0) << std::endl;
+        report.push_back({ {"name", r.name}, {"tests", r.tests}, {"ns_per_test", r.nsPerTest}, {"hit_rate", r.hitRate} });
+    }
+
+    if (report.empty()) {
+        std::cerr << "No pair class matched." << std::endl;
+        return -1;
+    }
+    std::cout << std::format("{:<48} {:>10.1f}", "mean over classes", totalNs / report.size()) << std::endl;
+
+    if (!jsonPath.empty()) {
+        std::ofstream ofs(jsonPath);
+        if (!ofs.is_open()) {
+            std::cerr << std::format("Failed to open '{}' for the report.", jsonPath) << std::endl;
+            return -1;
+        }
+        ofs << report.dump(2) << std::endl;
+    }
+
+    return 0;
+}
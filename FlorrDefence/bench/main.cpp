@@ -0,0 +1,319 @@
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <format>
+#include <chrono>
+#include <optional>
+#include <cstdlib>
+#include <filesystem>
+#include "AssetManager.hpp"
+#include "SpriteCollisionManager.hpp"
+#include "Constants.hpp"
+#include "Simulation.hpp"
+#include "PathIndex.hpp"
+#include "Profiler.hpp"
+#include "OS.hpp"
+#include "Tools.hpp"
+
+// A fixed board and mob population, see res/config/bench_scenarios.json
+struct Scenario {
+    std::string name;
+    std::string description;
+    float seconds = 30.f;
+    uint32_t seed = 1;
+    std::optional<CardInfo> fill;                              // Placed on every square that takes it
+    std::vector<std::pair<sf::Vector2i, CardInfo>> towers;    // Placed after the fill
+    size_t mobCount = 0;                                       // Topped up before every step
+    MobInfo mob;
+    bool spawner = false;                                      // Keep the regular spawner running as well
+    std::optional<size_t> drawMinPetals;                       // Draw every step, timing frames with this many petals
+};
+
+struct BenchResult {
+    std::string name;
+    int64_t steps = 0;
+    int64_t ticks = 0;
+    double wallSeconds = 0.0;
+    double ticksPerSecond = 0.0;
+    double nsPerMobUpdate = 0.0;
+    double testedPairsPerTick = 0.0;
+    double collidingPairsPerTick = 0.0;
+    size_t peakRss = 0;  // Of the process that ran only this scenario, loading included
+    int64_t drawnFrames = 0;  // Timed ones, with at least the scenario's petal count on the board
+    double drawMsPerFrame = 0.0;
+    double petalsPerDrawnFrame = 0.0;
+};
+
+static void from_json(const json& j, Scenario& s) {
+    s.name = j.at("name").get<std::string>();
+    s.description = j.value("description", std::string());
+    s.seconds = j.value("seconds", s.seconds);
+    s.seed = j.value("seed", s.seed);
+    s.spawner = j.value("spawner", s.spawner);
+
+    if (j.contains("towers")) {
+        const json& towers = j["towers"];
+        if (towers.contains("fill"))
+            s.fill = towers["fill"].get<CardInfo>();
+        for (const json& t : towers.value("place", json::array()))
+            s.towers.emplace_back(sf::Vector2i(t.at("row").get<int>(), t.at("col").get<int>()), t.at("card").get<CardInfo>());
+    }
+
+    if (j.contains("mobs")) {
+        s.mobCount = j["mobs"].at("count").get<size_t>();
+        s.mob = j["mobs"].get<MobInfo>();
+    }
+
+    if (j.contains("draw"))
+        s.drawMinPetals = j["draw"].value("min_petals", size_t{ 0 });
+}
+
+static std::vector<Scenario> loadScenarios(const std::string& path) {
+    std::ifstream ifs(path);
+    if (!ifs.is_open())
+        throw std::runtime_error(std::format("Failed to open {}", path));
+
+    json j;
+    ifs >> j;
+    return j.at("scenarios").get<std::vector<Scenario>>();
+}
+
+static void setUp(Simulation& sim, const Scenario& scenario) {
+    MapInfo& map = sim.getMap().getMapInfo();
+
+    if (scenario.fill) {
+        for (int row = 0; row < MAP_HEIGHT; row++)
+            for (int col = 0; col < MAP_WIDTH; col++)
+                if (map.isPlaceable({ row, col }, *scenario.fill))
+                    map.setCard({ row, col }, *scenario.fill);
+    }
+
+    for (const auto& [square, card] : scenario.towers)
+        map.setCard(square, card);
+
+    sim.getMap().getSpawner().setEnabled(scenario.spawner);
+}
+
+// Killed mobs are replaced at a random point of the path, so the load stays flat
+static size_t topUpMobs(Simulation& sim, const Scenario& scenario) {
+    MobSlots& mobs = sim.getMap().getMobs();
+    while (mobs.size() < scenario.mobCount) {
+        std::unique_ptr<Mob> mob = Mob::create(&sim.getInfo(), scenario.mob, mobs);
+        mob->setPathPosition(randomUniform(0.f, PathIndex::maxPosition));
+        mobs.push_back(std::move(mob));
+    }
+    return mobs.size();
+}
+
+static BenchResult run(const Scenario& scenario) {
+    seedGlobalRNG(scenario.seed);
+    Profiler::reset();
+
+    auto sim = std::make_unique<Simulation>();
+    sim->start();
+    setUp(*sim, scenario);
+
+    BenchResult result;
+    result.name = scenario.name;
+    int64_t mobUpdates = 0;
+
+    // Offscreen, so the bench still needs no window. Drawing is left out of the simulation wall time.
+    std::optional<sf::RenderTexture> canvas;
+    if (scenario.drawMinPetals)
+        canvas.emplace(sf::Vector2u(VIEW_SIZE));
+    std::chrono::duration<double> drawTime{};
+    std::chrono::duration<double> timedDrawTime{};
+    size_t drawnPetals = 0;
+
+    auto start = std::chrono::steady_clock::now();
+    while (sim->getSimulatedTime() < sf::seconds(scenario.seconds)) {
+        mobUpdates += (int64_t)topUpMobs(*sim, scenario);
+
+        // The flower must survive mobs reaching the end of the path
+        PlayerState& player = sim->getInfo().playerState;
+        player.hp = player.hpLimit;
+
+        sim->step(SIM_STEP);  // Exactly one simulation step
+        result.steps++;
+
+        if (canvas) {
+            auto drawStart = std::chrono::steady_clock::now();
+            canvas->clear();
+            canvas->draw(sim->getMap());
+            canvas->display();
+            std::chrono::duration<double> frame = std::chrono::steady_clock::now() - drawStart;
+            drawTime += frame;
+
+            // Frames before the board fills up, the first one building the static layers, are not timed
+            size_t petals = sim->getMap().getPetals().size();
+            if (petals >= *scenario.drawMinPetals) {
+                timedDrawTime += frame;
+                drawnPetals += petals;
+                result.drawnFrames++;
+            }
+        }
+    }
+    std::chrono::duration<double> wall = std::chrono::steady_clock::now() - start - drawTime;
+
+    const CollisionStats& collision = sim->getMap().getCollisionStats();
+    result.ticks = collision.ticks;
+    result.wallSeconds = wall.count();
+    result.ticksPerSecond = wall.count() > 0.0 ? collision.ticks / wall.count() : 0.0;
+    if (mobUpdates > 0)
+        result.nsPerMobUpdate = (double)Profiler::getTotal(ProfilePhase::MobUpdate).count() / mobUpdates;
+    if (collision.ticks > 0) {
+        result.testedPairsPerTick = (double)collision.testedPairs / collision.ticks;
+        result.collidingPairsPerTick = (double)collision.collidingPairs / collision.ticks;
+    }
+    if (result.drawnFrames > 0) {
+        result.drawMsPerFrame = timedDrawTime.count() * 1000.0 / result.drawnFrames;
+        result.petalsPerDrawnFrame = (double)drawnPetals / result.drawnFrames;
+    }
+    result.peakRss = OS::getPeakMemory();
+
+    return result;
+}
+
+static json toJson(const BenchResult& r) {
+    return {
+        {"name", r.name},
+        {"steps", r.steps},
+        {"ticks", r.ticks},
+        {"wall_seconds", r.wallSeconds},
+        {"ticks_per_second", r.ticksPerSecond},
+        {"ns_per_mob_update", r.nsPerMobUpdate},
+        {"tested_pairs_per_tick", r.testedPairsPerTick},
+        {"colliding_pairs_per_tick", r.collidingPairsPerTick},
+        {"peak_rss_bytes", r.peakRss},
+        {"drawn_frames", r.drawnFrames},
+        {"draw_ms_per_frame", r.drawMsPerFrame},
+        {"petals_per_drawn_frame", r.petalsPerDrawnFrame}
+    };
+}
+
+static BenchResult runAndPrint(const Scenario& scenario) {
+    std::cout << std::format("{} ({:.0f}s simulated): {}", scenario.name, scenario.seconds, scenario.description) << std::endl;
+    BenchResult r = run(scenario);
+
+    std::cout << std::format("  Ticks / sec:      {:.1f} ({} ticks in {:.3f}s)", r.ticksPerSecond, r.ticks, r.wallSeconds) << std::endl;
+    std::cout << std::format("  ns / mob update:  {:.1f}", r.nsPerMobUpdate) << std::endl;
+    std::cout << std::format("  Pairs / tick:     {:.1f} tested, {:.1f} colliding", r.testedPairsPerTick, r.collidingPairsPerTick) << std::endl;
+    std::cout << std::format("  Peak RSS:         {:.1f} MiB", r.peakRss / (1024.0 * 1024.0)) << std::endl;
+    if (scenario.drawMinPetals) {
+        if (r.drawnFrames > 0)
+            std::cout << std::format("  Draw:             {:.3f} ms / frame ({} frames, {:.0f} petals on average)", r.drawMsPerFrame, r.drawnFrames, r.petalsPerDrawnFrame) << std::endl;
+        else
+            std::cout << std::format("  Draw:             never reached {} petals, nothing timed", *scenario.drawMinPetals) << std::endl;
+    }
+    return r;
+}
+
+static std::string quoted(const std::string& arg) {
+    return "\"" + arg + "\"";
+}
+
+// Peak RSS is a high-water mark over the whole process, so a scenario run after a bigger one would report
+// the bigger one's peak. Each scenario is run by a fresh copy of this program with --only instead.
+static std::optional<json> runInChild(const std::string& self, const std::string& scenarioPath, const Scenario& scenario) {
+    std::filesystem::path reportPath = std::filesystem::temp_directory_path() / std::format("FlorrDefenceBench_{}.json", scenario.name);
+
+    std::string command = std::format("{} --scenarios {} --only {} --seconds {} --json {}",
+        quoted(self), quoted(scenarioPath), quoted(scenario.name), scenario.seconds, quoted(reportPath.string()));
+#ifdef _WIN32
+    command = quoted(command);  // cmd /c strips the outermost quotes
+#endif
+
+    if (int status = std::system(command.c_str()); status != 0) {
+        std::cerr << std::format("Scenario {} failed with status {}.", scenario.name, status) << std::endl;
+        return std::nullopt;
+    }
+
+    std::ifstream ifs(reportPath);
+    if (!ifs.is_open()) {
+        std::cerr << std::format("Scenario {} left no report.", scenario.name) << std::endl;
+        return std::nullopt;
+    }
+
+    json report;
+    ifs >> report;
+    ifs.close();
+    std::filesystem::remove(reportPath);
+    return report.at(0);
+}
+
+// Usage: FlorrDefenceBench [--scenarios PATH] [--only NAME] [--seconds N] [--json PATH]
+// A single scenario runs in this process, several run one per child process.
+int main(int argc, char* argv[]) {
+    std::string scenarioPath = "res/config/bench_scenarios.json";
+    std::string only;
+    std::optional<float> seconds;
+    std::string jsonPath;
+
+    for (int i = 1; i + 1 < argc; i += 2) {
+        std::string arg = argv[i];
+        if (arg == "--scenarios")
+            scenarioPath = argv[i + 1];
+        else if (arg == "--only")
+            only = argv[i + 1];
+        else if (arg == "--seconds")
+            seconds = std::stof(argv[i + 1]);
+        else if (arg == "--json")
+            jsonPath = argv[i + 1];
+        else {
+            std::cerr << "Unknown argument: " << arg << std::endl;
+            return -1;
+        }
+    }
+
+    std::cout << "--- Florr Defence (bench) ---" << std::endl;
+
+    std::vector<Scenario> scenarios;
+    try {
+        scenarios = loadScenarios(scenarioPath);
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Failed to load scenarios: " << e.what() << std::endl;
+        return -1;
+    }
+
+    std::erase_if(scenarios, [&](const Scenario& scenario) { return !only.empty() && scenario.name != only; });
+    if (scenarios.empty()) {
+        std::cerr << "No scenario matched." << std::endl;
+        return -1;
+    }
+    if (seconds) {
+        for (Scenario& scenario : scenarios)
+            scenario.seconds = *seconds;
+    }
+
+    json report = json::array();
+    if (scenarios.size() > 1) {
+        for (const Scenario& scenario : scenarios) {
+            std::optional<json> result = runInChild(argv[0], scenarioPath, scenario);
+            if (!result)
+                return -1;
+            report.push_back(std::move(*result));
+        }
+    }
+    else {
+        loadConstants();
+        AssetManager::load();
+        SpriteCollisionManager::load();
+
+        // Mob update time comes from the profiler, its per-frame ring buffer is not used
+        Profiler::setEnabled(true);
+
+        report.push_back(toJson(runAndPrint(scenarios.front())));
+    }
+
+    if (!jsonPath.empty()) {
+        std::ofstream ofs(jsonPath);
+        if (!ofs.is_open()) {
+            std::cerr << std::format("Failed to open '{}' for the report.", jsonPath) << std::endl;
+            return -1;
+        }
+        ofs << report.dump(2) << std::endl;
+    }
+
+    return 0;
+}
@@ -5,13 +5,15 @@
 #include <stdexcept>
 #include <SFML/Graphics.hpp>
 #include "Constants.hpp"
+#include "TextureAtlas.hpp"
 
 struct TexEntry {
     bool isTexture = false;
-    std::unique_ptr<sf::Texture> tex;
+    std::unique_ptr<sf::Texture> tex;  // Only for textures kept out of the atlas
+    TexRegion region;
     std::unordered_map<std::string, std::unique_ptr<TexEntry>> subs;
 
-    operator const sf::Texture& () const;
+    operator const sf::Texture& () const;  // Not for atlas entries, they only own a sub-rect of a page
     const TexEntry& operator[](const std::string& name) const;
 
     template<typename... Args>
@@ -45,19 +47,25 @@ public:
         return getTexture("ui", names...);
     }
 
+    // Mobs, petals and cards are packed into the atlas, sprites need the sub-rect as well
     template<typename... Args>
-    static const sf::Texture& getCardTexture(const Args&... names) {
-        return getTexture("cards", names...);
+    static const TexRegion& getRegion(const Args&... names) {
+        return getInstance().m_entry.get(names...).region;
     }
 
     template<typename... Args>
-    static const sf::Texture& getMobTexture(const Args&... names) {
-        return getTexture("mobs", names...);
+    static const TexRegion& getCardRegion(const Args&... names) {
+        return getRegion("cards", names...);
     }
 
     template<typename... Args>
-    static const sf::Texture& getPetalTexture(const Args&... names) {
-        return getTexture("petals", names...);
+    static const TexRegion& getMobRegion(const Args&... names) {
+        return getRegion("mobs", names...);
+    }
+
+    template<typename... Args>
+    static const TexRegion& getPetalRegion(const Args&... names) {
+        return getRegion("petals", names...);
     }
 
     template<typename... Args>
@@ -90,6 +98,7 @@ private:
 
 private:
     TexEntry m_entry;
+    TextureAtlas m_atlas;
     sf::Font m_font;
     std::unordered_map<std::string, sf::Shader> m_shaders;
 };
@@ -0,0 +1,82 @@
+#pragma once
+#include <string>
+#include <array>
+#include <bitset>
+#include <optional>
+#include <unordered_map>
+#include <cstdint>
+
+// Attributes read by the game code. Config attributes are compiled into an AttribTable at load,
+// so a lookup is an array index. Attributes not listed here (e.g. the buff tower "*_buff" values)
+// stay reachable by name through RarityEntry::attribs.
+enum class Attrib : uint8_t {
+    // Towers and petals
+    Armor,
+    ArmorDebuff,
+    ArmorDebuffDuration,
+    BounceRange,
+    Bounces,
+    Copy,
+    Damage,
+    DamageIncrease,
+    DamageIncreaseRate,
+    DeathHeal,
+    Duration,
+    Evasion,
+    Heal,
+    Hp,
+    Knockback,
+    MaxDamageRate,
+    MobRarity,
+    PetalHeal,
+    Radius,
+    Range,
+    Reload,
+    Scale,
+    Shield,
+    SlowDown,
+    SlowDownDuration,
+    Speed,
+
+    // Mobs, shared names such as Evasion and SlowDownDuration are listed above
+    AbovegroundDurationHigh,
+    AbovegroundDurationLow,
+    MaxDuration,
+    MoveDurationHigh,
+    MoveDurationLow,
+    PostShootDelay,
+    PreShootDelay,
+    RestDuration,
+    RestDurationJitter,
+    RotationRange,
+    RotationSpeed,
+    RunningDuration,
+    RunningDurationJitter,
+    RunningSpeed,
+    ShootInterval,
+    ShootIntervalJitter,
+    SpawnChance,
+    SpawnDurationHigh,
+    SpawnDurationLow,
+    SpeedUpDuration,
+    UndergroundDurationHigh,
+    UndergroundDurationLow,
+
+    Count
+};
+
+const std::string& attribToString(Attrib attrib);
+std::optional<Attrib> stringToAttrib(const std::string& str);  // nullopt for extension attributes
+
+class AttribTable {
+public:
+    static AttribTable compile(const std::unordered_map<std::string, float>& attribs);
+
+    bool has(Attrib attrib) const { return m_present[(size_t)attrib]; }
+    float get(Attrib attrib) const;  // Throws std::out_of_range if the config doesn't set it
+    void set(Attrib attrib, float value);
+
+private:
+    std::array<float, (size_t)Attrib::Count> m_values = {};
+    std::bitset<(size_t)Attrib::Count> m_present;
+};
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstdint>
+#include "RecordSnapshot.hpp"
+
+// Compact game record, same content as the JSON record. Written from and read into a RecordSnapshot directly,
+// no JSON document is built on the way.
+//
+// Layout, every field little-endian and fixed-width:
+//   header         char[4] magic "FDRB", u16 version, u16 section count
+//   section table  per section: char[4] tag, u32 offset from the file start, u32 size
+//   sections       STRS string table, PLYR player, MAP map, SHOP shops, TLNT talents,
+//                  CKPT u64 journal checkpoint id (see RecordJournal.hpp), optional
+//
+// Card names and other repeated strings are stored once in STRS and referenced by u16 index.
+// Sections with an unknown tag are skipped, so older readers load newer records of the same version.
+class BinaryRecord {
+public:
+	inline static constexpr char magic[4] = { 'F', 'D', 'R', 'B' };
+	inline static constexpr uint16_t version = 1;
+
+	static bool isBinary(std::string_view bytes);
+
+	// The backpack must be present, CKPT is only written with a checkpoint id
+	static std::string encode(const RecordSnapshot& record);
+	// Sections missing from the record are left empty, the backpack unset.
+	// Throws std::runtime_error on a malformed record.
+	static RecordSnapshot decode(std::string_view bytes);
+};
+
+// Little-endian writer, independent of the host byte order
+class BinaryWriter {
+public:
+	void u8(uint8_t value) { m_data.push_back((char)value); }
+	void u16(uint16_t value);
+	void u32(uint32_t value);
+	void i32(int32_t value) { u32((uint32_t)value); }
+	void i64(int64_t value);
+	void f32(float value);
+	void bytes(std::string_view bytes) { m_data.append(bytes); }
+
+	size_t size() const { return m_data.size(); }
+	std::string& data() { return m_data; }
+
+private:
+	std::string m_data;
+};
+
+// Reads what BinaryWriter wrote, throws std::runtime_error past the end
+class BinaryReader {
+public:
+	BinaryReader(std::string_view data) : m_data(data) {}
+
+	uint8_t u8();
+	uint16_t u16();
+	uint32_t u32();
+	int32_t i32() { return (int32_t)u32(); }
+	int64_t i64();
+	float f32();
+	std::string_view bytes(size_t count);
+
+	bool atEnd() const { return m_pos == m_data.size(); }
+
+private:
+	const unsigned char* take(size_t count);
+
+private:
+	std::string_view m_data;
+	size_t m_pos = 0;
+};
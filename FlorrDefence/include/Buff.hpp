@@ -3,170 +3,182 @@
 #include <map>
 #include <set>
 #include <vector>
-#include <functional>
-#include <stdexcept>
+#include <array>
+#include <utility>
+#include <cstdint>
+#include <tuple>
+#include <optional>
+#include <unordered_map>
 #include <SFML/Graphics.hpp>
+#include "Constants.hpp"
+
+enum class BuffType : uint8_t {
+	Speed,
+	BodyDamage,
+	HealValue,
+	Overheal,
+	Reload,
+	Damage,
+	Summoner,
+	Reach,
+	Luck,
+	Health,
+	Evasion,
+	DamageReduction,
+	MobSpawnRate,
+	Shop,
+	Antennae,
+	YinYang,
+
+	Count
+};
 
-class Buff {
-public:
-	using Func = std::function<float(float, float)>;
-
-	inline static const Func Min = [](float a, float b) { return a < b ? a : b; };
-	inline static const Func Max = [](float a, float b) { return a > b ? a : b; };
-	inline static const Func Add = [](float a, float b) { return a + b; };
-	inline static const Func Mul = [](float a, float b) { return a * b; };
-	inline static const Func AddFactor = [](float a, float b) { return a + a * b; };
-	inline static const Func AddFactor2 = [](float a, float b) { return a + (a + 1) * b; };
-	inline static const Func AddFactor3 = [](float a, float b) { return a + (1 - a) * b; };
-	inline static const Func SubFactor = [](float a, float b) { return a - a * b; };
+BuffType stringToBuffType(const std::string& str);  // Throws std::runtime_error for unknown names
+
+enum class BuffOp : uint8_t {
+	Min,
+	Max,
+	Add,
+	Mul,
+	AddFactor,
+	AddFactor2,
+	AddFactor3,
+	SubFactor
+};
 
-public:
-	Buff(const Func& addFunc, const Func& applyFunc)
-		: m_addFunc(addFunc), m_applyFunc(applyFunc) {
+constexpr float applyBuffOp(BuffOp op, float a, float b) {
+	switch (op) {
+	case BuffOp::Min: return a < b ? a : b;
+	case BuffOp::Max: return a > b ? a : b;
+	case BuffOp::Add: return a + b;
+	case BuffOp::Mul: return a * b;
+	case BuffOp::AddFactor: return a + a * b;
+	case BuffOp::AddFactor2: return a + (a + 1) * b;
+	case BuffOp::AddFactor3: return a + (1 - a) * b;
+	case BuffOp::SubFactor: return a - a * b;
 	}
+	return a;
+}
 
-	void add(float value) { m_value = m_addFunc(m_value, value); }
-
-	float apply(float value) const { return m_applyFunc(value, m_value); }
-
-	void set(float value = 0.f) { m_value = value; }
-
-	float get() const { return m_value; }
-
-private:
-	float m_value = 0.f;
-	const Func& m_addFunc;
-	const Func& m_applyFunc;
+struct BuffRule {
+	BuffOp add;    // Stacking two sources of the same group
+	BuffOp apply;  // Applying the buff to a base value
+	BuffOp merge;  // Combining tower and talent groups
 };
 
-struct BuffGroup {
-	Buff speed;
-	Buff bodyDamage;
-	Buff healValue;
-	Buff overheal;
-	Buff reload;
-	Buff damage;
-	Buff summoner;
-	Buff reach;
-	Buff luck;
-	Buff health;
-	Buff evasion;
-	Buff damage_reduction;
-	Buff mob_spawn_rate;
-	Buff shop;
-	Buff antennae;
-	Buff yin_yang;
-
-	std::unordered_map<std::string, Buff*> buffs;
-
-	BuffGroup()
-		: speed(Buff::Add, Buff::AddFactor),
-		  bodyDamage(Buff::Add, Buff::Add),
-		  healValue(Buff::Add, Buff::Add),
-		  overheal(Buff::Add, Buff::Mul),
-		  reload(Buff::Min, Buff::AddFactor),
-		  damage(Buff::Add, Buff::AddFactor),
-		  summoner(Buff::Add, Buff::AddFactor),
-		  reach(Buff::Add, Buff::AddFactor),
-		  luck(Buff::Add, Buff::Add),
-		  health(Buff::Add, Buff::AddFactor),
-		  evasion(Buff::Add, Buff::Mul),
-		  damage_reduction(Buff::Add, Buff::SubFactor),
-		  mob_spawn_rate(Buff::Add, Buff::AddFactor),
-		  shop(Buff::Max, Buff::Max),
-		  antennae(Buff::Max, Buff::Max),
-		  yin_yang(Buff::Max, Buff::Max)
-	{
-		buffs = {
-			{"speed", &speed},
-			{"body_damage", &bodyDamage},
-			{"heal_value", &healValue},
-			{"overheal", &overheal},
-			{"reload", &reload},
-			{"damage", &damage},
-			{"summoner", &summoner},
-			{"reach", &reach},
-			{"luck", &luck},
-			{"health", &health},
-			{"evasion", &evasion},
-			{"damage_reduction", &damage_reduction},
-			{"mob_spawn_rate", &mob_spawn_rate},
-			{"shop", &shop},
-			{"antennae", &antennae},
-			{"yin_yang", &yin_yang}
-		};
+// Indexed by BuffType
+inline constexpr std::array<BuffRule, (size_t)BuffType::Count> BUFF_RULES = { {
+	{ BuffOp::Add, BuffOp::AddFactor, BuffOp::Add },         // Speed
+	{ BuffOp::Add, BuffOp::Add, BuffOp::Add },               // BodyDamage
+	{ BuffOp::Add, BuffOp::Add, BuffOp::Add },               // HealValue
+	{ BuffOp::Add, BuffOp::Mul, BuffOp::Add },               // Overheal
+	{ BuffOp::Min, BuffOp::AddFactor, BuffOp::AddFactor2 },  // Reload
+	{ BuffOp::Add, BuffOp::AddFactor, BuffOp::Add },         // Damage
+	{ BuffOp::Add, BuffOp::AddFactor, BuffOp::Add },         // Summoner
+	{ BuffOp::Add, BuffOp::AddFactor, BuffOp::Add },         // Reach
+	{ BuffOp::Add, BuffOp::Add, BuffOp::Add },               // Luck
+	{ BuffOp::Add, BuffOp::AddFactor, BuffOp::Add },         // Health
+	{ BuffOp::Add, BuffOp::Mul, BuffOp::AddFactor3 },        // Evasion
+	{ BuffOp::Add, BuffOp::SubFactor, BuffOp::AddFactor3 },  // DamageReduction
+	{ BuffOp::Add, BuffOp::AddFactor, BuffOp::Add },         // MobSpawnRate
+	{ BuffOp::Max, BuffOp::Max, BuffOp::Max },               // Shop
+	{ BuffOp::Max, BuffOp::Max, BuffOp::Max },               // Antennae
+	{ BuffOp::Max, BuffOp::Max, BuffOp::Max },               // YinYang
+} };
+
+// One value per buff type. apply<T>() resolves its operator at compile time,
+// the runtime overloads are for buffs named in config files.
+// The version changes whenever a value does, so derived values can be cached against it.
+class BuffGroup {
+public:
+	template <BuffType T>
+	float apply(float value) const {
+		constexpr BuffOp op = BUFF_RULES[(size_t)T].apply;
+		return applyBuffOp(op, value, m_values[(size_t)T]);
 	}
 
-	Buff& get(const std::string& name) {
-		auto it = buffs.find(name);
-		if (it == buffs.end())
-			throw std::runtime_error("Unknown buff name: " + name);
-		return *it->second;
+	float apply(BuffType type, float value) const {
+		return applyBuffOp(BUFF_RULES[(size_t)type].apply, value, m_values[(size_t)type]);
 	}
 
-	const Buff& get(const std::string& name) const {
-		auto it = buffs.find(name);
-		if (it == buffs.end())
-			throw std::runtime_error("Unknown buff name: " + name);
-		return *it->second;
+	void add(BuffType type, float value) {
+		float& current = m_values[(size_t)type];
+		current = applyBuffOp(BUFF_RULES[(size_t)type].add, current, value);
+		m_version++;
 	}
 
-	void reset() {
-		for (auto& [_, buff] : buffs)
-			buff->set();
-	}
+	void set(BuffType type, float value = 0.f) { m_values[(size_t)type] = value; m_version++; }
+	float get(BuffType type) const { return m_values[(size_t)type]; }
+	uint64_t getVersion() const { return m_version; }
+
+	void reset() { m_values.fill(0.f); m_version++; }
 
 	void mergeFrom(const BuffGroup& group1, const BuffGroup& group2) {
-		for (auto& [name, buff] : buffs) {
-			buff->set(group1.get(name).get());
-			buff->add(group2.get(name).get());
+		mergeFrom(group1, group2, std::make_index_sequence<(size_t)BuffType::Count>());
+	}
+
+private:
+	template <size_t... I>
+	void mergeFrom(const BuffGroup& group1, const BuffGroup& group2, std::index_sequence<I...>) {
+		std::array<float, (size_t)BuffType::Count> merged = {
+			applyBuffOp(BUFF_RULES[I].merge, group1.m_values[I], group2.m_values[I])...
+		};
+
+		// Merged every tick, but the version only moves when something changed
+		if (merged != m_values) {
+			m_values = merged;
+			m_version++;
 		}
-		reload.set(Buff::AddFactor2(group1.reload.get(), group2.reload.get()));
-		evasion.set(Buff::AddFactor3(group1.evasion.get(), group2.evasion.get()));
-		damage_reduction.set(Buff::AddFactor3(group1.damage_reduction.get(), group2.damage_reduction.get()));
 	}
+
+private:
+	std::array<float, (size_t)BuffType::Count> m_values = {};
+	uint64_t m_version = 0;
 };
 
-struct BuffManager {
+// Decides which buff tower of each card type is active and keeps the resulting tower buff group.
+// Towers are added and removed one at a time, and only card types whose winner changes are
+// recomputed. The epoch lets consumers cache values derived from the tower buff.
+class BuffManager {
 public:
-	struct Entry {
-		std::string rarity;
-		sf::Vector2i square;
-	};
+	void add(const CardInfo& card, sf::Vector2i square);
+	void remove(const CardInfo& card, sf::Vector2i square);
+	void setTalentAntennaeLevel(int level);
+	void clear();
 
-	void setAntennaeLevel(int antennaeLevel) {
-		m_antennaeLevel = antennaeLevel;
-		m_cards.clear();
-	}
+	bool find(const CardInfo& card, sf::Vector2i square) const;  // Whether the tower at square is active
+	const BuffGroup& getBuff() const { return m_buff; }
+	int getAntennaeLevel() const { return m_antennaeLevel; }
+	uint64_t getEpoch() const { return m_epoch; }  // Bumped whenever an active tower changes
 
-	void add(const CardInfo& card, sf::Vector2i square) {
-		if (FLOWER_BUFF_TOWERS.contains(card.type) &&
-			RARITIE_LEVELS.at(card.rarity) > m_antennaeLevel)
-			return;
+private:
+	struct Candidate {
+		int level;
+		sf::Vector2i square;
+		InternedString rarity;
 
-		auto it = m_cards.find(card.type);
-		if (it == m_cards.end() ||
-			RARITIE_LEVELS.at(card.rarity) > RARITIE_LEVELS.at(it->second.rarity)) {
-			m_cards[card.type] = Entry{ card.rarity, square };
+		// Highest rarity first, ties go to the first square in row-major order
+		bool operator<(const Candidate& other) const {
+			return std::tuple(-level, square.x, square.y) < std::tuple(-other.level, other.square.x, other.square.y);
 		}
-	}
+	};
 
-	bool find(const CardInfo& card, sf::Vector2i square) const {
-		auto it = m_cards.find(card.type);
-		if (it == m_cards.end())
-			return false;
-		return it->second.square == square;
-	}
+	struct TypeEntry {
+		bool flower = false;  // Only active up to the antennae level
+		std::set<Candidate> candidates;
+		std::optional<Candidate> winner;
+		std::vector<std::pair<BuffType, float>> contributions;  // The winner's "*_buff" attributes
+	};
 
-	std::vector<sf::Vector2i> getSquares() const {
-		std::vector<sf::Vector2i> squares;
-		squares.reserve(m_cards.size());
-		for (const auto& [_, entry] : m_cards)
-			squares.push_back(entry.square);
-		return squares;
-	}
+private:
+	void updateWinner(InternedString type, TypeEntry& entry);
+	void updateAntennaeLevel();
+	void recompute(BuffType type);
 
 private:
+	int m_talentAntennaeLevel = 0;
 	int m_antennaeLevel = 0;
-	std::unordered_map<std::string, Entry> m_cards;
+	std::unordered_map<InternedString, TypeEntry> m_types;
+	BuffGroup m_buff;
+	uint64_t m_epoch = 0;
 };
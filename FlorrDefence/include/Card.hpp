@@ -51,8 +51,18 @@ private:
 };
 
 class TowerCard : public Card {
+public:
+	// Bottom to top. Only the reload overlay changes between placements.
+	enum class Part {
+		Background,
+		Reload,
+		Image
+	};
+
 public:
 	void setReload(float reload, bool top);
+	void drawPart(Part part, sf::RenderTarget& target, sf::RenderStates states) const;
+	void writeReloadQuad(sf::Vertex* quad, const sf::Transform& transform) const;  // 6 vertices, two triangles
 
 private:
 	void draw(sf::RenderTarget& target, sf::RenderStates states) const override;
@@ -60,5 +70,4 @@ private:
 private:
 	float m_reload = 1.f;
 	bool m_top = false;
-	mutable sf::RectangleShape m_reloadRect;
 };
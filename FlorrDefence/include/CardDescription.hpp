@@ -1,10 +1,12 @@
 #pragma once
 #include <unordered_map>
+#include <optional>
 #include <SFML/Graphics.hpp>
 #include <nlohmann/json.hpp>
 #include "RoundRect.hpp"
 #include "Constants.hpp"
 #include "Buff.hpp"
+#include "PathIndex.hpp"
 
 class LabelEntry : public sf::Drawable, public sf::Transformable {
 public:
@@ -32,10 +34,11 @@ class CardDescription : public sf::Drawable {
 public:
 	CardDescription(const BuffGroup& buff);
 
-	void set(const CardInfo& card, sf::Vector2f cardCenter, float cardSize);
+	// targetMode for a placed tower that has one, shown as a label
+	void set(const CardInfo& card, sf::Vector2f cardCenter, float cardSize, std::optional<TargetMode> targetMode = std::nullopt);
 
 	void reset() { m_isVerified = false; }
-	void clear() { m_card = {}; m_cardCenter = {}; reset(); }  // run this when buff is updated
+	void clear() { m_card = {}; m_targetMode.reset(); m_cardCenter = {}; reset(); }  // run this when buff is updated
 	bool isVerified() const { return m_isVerified; }
 
 private:
@@ -68,6 +71,7 @@ private:
 	const BuffGroup& m_buff;
 
 	CardInfo m_card;
+	std::optional<TargetMode> m_targetMode;
 	sf::Vector2f m_cardCenter;
 	float m_cardSize = 0.f;
 	bool m_isVerified = false;
@@ -0,0 +1,30 @@
+#pragma once
+#include <SFML/Graphics.hpp>
+#include <vector>
+
+// Uniform grid broadphase, entries are ids given by the caller
+class CollisionGrid {
+public:
+    CollisionGrid(sf::FloatRect bounds, sf::Vector2f cellSize);
+
+    void clear();
+    void insert(int id, const sf::FloatRect& box);
+    void query(const sf::FloatRect& box, std::vector<int>& result) const;  // Sorted, no duplicates
+
+private:
+    sf::IntRect getCellRange(const sf::FloatRect& box) const;  // Clamped to the grid, inclusive
+
+private:
+    sf::FloatRect m_bounds;
+    sf::Vector2f m_cellSize;
+    int m_cols;
+    int m_rows;
+    std::vector<std::vector<int>> m_cells;
+};
+
+struct CollisionStats {
+    int64_t ticks = 0;
+    int64_t bruteForcePairs = 0;  // Petals x mobs, what the old all-pairs loop tested
+    int64_t testedPairs = 0;      // Pairs that reached SpriteCollisionManager::isCollide
+    int64_t collidingPairs = 0;
+};
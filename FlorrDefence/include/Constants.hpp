@@ -6,16 +6,20 @@
 #include <unordered_set>
 #include <SFML/Graphics.hpp>
 #include <nlohmann/json.hpp>
+#include "InternedString.hpp"
+#include "Attrib.hpp"
 
 inline const int MAP_HEIGHT = 11;
 inline const int MAP_WIDTH = 10;
 
 inline const sf::Vector2f VIEW_SIZE(1700.f, 1100.f);
 inline const sf::Vector2u WINDOW_INIT_SIZE(850u, 550u);
+inline const unsigned ANTI_ALIASING_LEVEL = 6;  // Of the window, and of render textures drawn into it
 
+// Rarity and type are interned, so cards compare as two small ids. Text only at the JSON boundary.
 struct CardInfo {
-	std::string rarity;
-	std::string type;
+	InternedString rarity;
+	InternedString type;
 
 	bool operator==(const CardInfo& other) const {
 		return rarity == other.rarity && type == other.type;
@@ -28,14 +32,14 @@ struct CardInfo {
 
 inline void to_json(nlohmann::json& j, const CardInfo& c) {
 	j = {
-		{"rarity", c.rarity},
-		{"type", c.type}
+		{"rarity", c.rarity.str()},
+		{"type", c.type.str()}
 	};
 }
 
 inline void from_json(const nlohmann::json& j, CardInfo& c) {
-	j.at("rarity").get_to(c.rarity);
-	j.at("type").get_to(c.type);
+	c.rarity = j.at("rarity").get<std::string>();
+	c.type = j.at("type").get<std::string>();
 }
 
 using MobInfo = CardInfo;
@@ -61,6 +65,7 @@ struct TowerAttribs {
 		int64_t price = 0;
 		int64_t coin = 0;
 		std::unordered_map<std::string, float> attribs;
+		AttribTable table;  // Compiled from attribs at load
 	};
 	std::string type;
 	DamageType damageType = DamageType::Normal;
@@ -80,6 +85,7 @@ struct MobAttribs {
 		int64_t coinDrop = 0;
 		int xpDrop = 0;
 		std::unordered_map<std::string, float> attribs;
+		AttribTable table;  // Compiled from attribs at load
 	};
 	std::unordered_map<std::string, RarityEntry> rarities;
 
@@ -126,6 +132,7 @@ const sf::Time TICK = sf::milliseconds(125);
 extern const std::vector<std::string> RARITIES;
 extern const std::vector<std::string> SHOP_RARITIES;
 extern const std::unordered_map<std::string, int> RARITIE_LEVELS;
+int getRarityLevel(InternedString rarity);  // RARITIE_LEVELS by id, throws std::out_of_range if unknown
 
 extern const std::unordered_map<std::string, std::string> TOWER_SUMMON_MOBS;
 
@@ -143,7 +150,7 @@ extern const std::unordered_map<std::string, sf::Color> DARK_COLORS;
 extern InitStates INIT_STATES;
 extern std::vector<std::string> TOWER_TYPES;
 extern std::unordered_map<std::string, TowerAttribs> TOWER_ATTRIBS;
-extern std::unordered_set<std::string> FLOWER_BUFF_TOWERS;
+extern std::unordered_set<InternedString> FLOWER_BUFF_TOWERS;
 extern std::unordered_map<std::string, MobAttribs> MOB_ATTRIBS;
 extern std::unordered_map<std::string, float> MOB_RARITY_FLOWER_DAMGE_MUL;
 extern std::unordered_map<std::string, ShopAttribs> SHOP_ATTRIBS;
@@ -157,6 +164,11 @@ extern std::string LOAD_PATH_DEFAULT;
 extern std::string SAVE_PATH_DEFAULT;
 extern bool AUTO_SAVE_ENABLED;
 extern int AUTO_SAVE_INTERVAL_SECONDS;
+extern bool SAVE_JOURNAL_ENABLED;  // Saves append changed sections to <record>.journal, see RecordJournal.hpp
 extern bool SHOW_CONSOLE;
 extern bool DEBUG_MODE;
 extern bool VSYNC_ENABLED;
+extern bool PROFILER_ENABLED;             // Per-phase frame timings, exported with F9 and at exit
+extern std::string PROFILER_EXPORT_PATH;  // .csv or .json
+extern int SIM_RATE;      // Simulation steps per second, independent of frame rate
+extern sf::Time SIM_STEP;  // 1 / SIM_RATE
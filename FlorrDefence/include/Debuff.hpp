@@ -7,8 +7,8 @@
 struct DurationDebuff {
     DurationDebuff() = default;
 
-    DurationDebuff(float value_, const std::string rarity, const sf::Time duration_)
-        : value(value_), level(RARITIE_LEVELS.at(rarity)), duration(duration_) {
+    DurationDebuff(float value_, InternedString rarity, const sf::Time duration_)
+        : value(value_), level(getRarityLevel(rarity)), duration(duration_) {
     }
 
     void update(sf::Time dt) {
@@ -35,8 +35,8 @@ struct DurationDebuff {
 struct ValueDebuff {
     ValueDebuff() = default;
 
-    ValueDebuff(float value_, const std::string rarity)
-        : value(value_), level(RARITIE_LEVELS.at(rarity)), active(true) {}
+    ValueDebuff(float value_, InternedString rarity)
+        : value(value_), level(getRarityLevel(rarity)), active(true) {}
 
     bool is_active() const {
         return active;
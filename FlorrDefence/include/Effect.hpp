@@ -1,6 +1,7 @@
 #pragma once
 #include <SFML/Graphics.hpp>
 #include "SharedInfo.hpp"
+#include "ObjectPool.hpp"
 
 class Effect : public sf::Drawable {
 public:
@@ -18,6 +19,10 @@ class LightningEffect : public Effect {
 public:
 	LightningEffect(const SharedInfo* info, sf::Vector2f root, int rootConnected, std::vector<sf::Vector2f> positions);
 
+	static void* operator new(size_t size) { return getPool().allocate(size); }
+	static void operator delete(void* ptr, size_t size) { getPool().deallocate(ptr, size); }
+	static ObjectPool& getPool();
+
 	void update();
 	bool isDone();
 
@@ -0,0 +1,40 @@
+#pragma once
+#include <map>
+#include <cstdint>
+#include "Constants.hpp"
+#include "Buff.hpp"
+
+// Buffed attributes of one card, shared by its towers and petals.
+// Attributes the card doesn't have stay 0.
+struct EffectiveStats {
+    float reload = 0.f;        // Seconds
+    float range = 0.f;         // Pixels, reach applied
+    float rangeSquared = 0.f;
+    float damage = 0.f;
+    float speed = 0.f;         // Squares per second
+    float copy = 0.f;
+};
+
+// Recomputes a card's stats only when the buff group they were derived from changes version
+class EffectiveStatsCache {
+public:
+    struct Entry {
+        const TowerAttribs::RarityEntry* attribs = nullptr;
+        uint64_t version = UINT64_MAX;
+        EffectiveStats stats;
+    };
+
+    Entry& getEntry(const CardInfo& card);  // Stays valid for the lifetime of the cache
+
+    static const EffectiveStats& get(Entry& entry, const BuffGroup& buff) {
+        if (entry.version != buff.getVersion())
+            recompute(entry, buff);
+        return entry.stats;
+    }
+
+private:
+    static void recompute(Entry& entry, const BuffGroup& buff);
+
+private:
+    std::map<CardInfo, Entry> m_entries;
+};
@@ -1,11 +1,14 @@
 #pragma once
+#include <optional>
 #include <SFML/Graphics.hpp>
 #include "SharedInfo.hpp"
 #include "Constants.hpp"
+#include "SpriteBatch.hpp"
+#include "TextureAtlas.hpp"
 
 class Entity : public sf::Drawable {
 public:
-    Entity(SharedInfo* info, const sf::Texture& texture);
+    Entity(SharedInfo* info, const TexRegion& region);
 
     virtual void hit(int damage, DamageType type = DamageType::Normal);
     void kill() { hit(m_hp, DamageType::Lightning); }
@@ -17,6 +20,9 @@ public:
     virtual int getArmor() const { return 0; }
     void updatePathPosition(float position);
     void updateAnimation();
+    void savePrevious();  // Called before each simulation step
+    void draw(SpriteBatch& batch) const;  // The batch has to be drawn with getFlashShader()
+    static const sf::Shader* getFlashShader();
 
     const sf::Sprite& getSprite() const { return m_sprite; }
     const sf::Texture& getTexture() const { return m_sprite.getTexture(); }
@@ -31,9 +37,13 @@ protected:
     void setScale(float scale);
     void setFlash(sf::Color color, float brightness);
     void setAlpha(float alpha);
+    void setTexture(const TexRegion& region);
 
 private:
     void draw(sf::RenderTarget& target, sf::RenderStates states) const override;
+    std::optional<float> prepareSprite() const;  // Flash brightness, nullopt if there is nothing to draw
+    template <typename DrawFn>
+    void drawInterpolated(DrawFn drawSprite) const;
 
 public:
     inline static const sf::Time flashDuration = sf::seconds(0.15f);
@@ -53,4 +63,9 @@ private:
     float m_flashBrightness = 1.f;
     sf::Time m_flashTime;
     sf::Time m_deathTime;
+
+    // Render interpolation
+    bool m_hasPrevious = false;
+    sf::Vector2f m_prevPosition;
+    sf::Angle m_prevRotation;
 };
@@ -32,7 +32,8 @@ private:
     void render();
 
     void handleFileDialog();
-    bool trySaveToPath(const std::filesystem::path& path, bool ignoreThreshold = false);
+    bool trySaveToPath(const std::filesystem::path& path, bool ignoreThreshold = false, bool async = false);
+    void pollSave();
 
 private:
     sf::RenderWindow* m_window;
@@ -0,0 +1,54 @@
+#pragma once
+#include <string>
+#include <cstdint>
+#include <format>
+#include <ostream>
+#include <functional>
+
+// A string stored once in a global table and referred to by a small id.
+// Copying, comparing and hashing only touch the id; the text is kept for the JSON boundary,
+// string keyed config lookups and display.
+class InternedString {
+public:
+    InternedString();  // ""
+    InternedString(const std::string& str);
+    InternedString(const char* str);
+
+    uint16_t getId() const { return m_id; }
+    const std::string& str() const;
+    operator const std::string&() const { return str(); }
+
+    // Ordered by id, i.e. by first appearance rather than alphabetically
+    bool operator==(const InternedString& other) const = default;
+    auto operator<=>(const InternedString& other) const = default;
+
+    // Text comparisons, for code off the hot paths. Hot paths compare against a stored InternedString.
+    bool operator==(const char* other) const { return str() == other; }
+    bool operator==(const std::string& other) const { return str() == other; }
+
+    static size_t getCount();  // Distinct strings interned so far
+
+private:
+    uint16_t m_id;
+};
+
+inline std::ostream& operator<<(std::ostream& os, const InternedString& s) {
+    return os << s.str();
+}
+
+inline std::string operator+(const InternedString& a, const std::string& b) { return a.str() + b; }
+inline std::string operator+(const std::string& a, const InternedString& b) { return a + b.str(); }
+inline std::string operator+(const InternedString& a, const char* b) { return a.str() + b; }
+inline std::string operator+(const char* a, const InternedString& b) { return a + b.str(); }
+
+template <>
+struct std::hash<InternedString> {
+    size_t operator()(const InternedString& s) const noexcept { return s.getId(); }
+};
+
+template <>
+struct std::formatter<InternedString> : std::formatter<std::string> {
+    auto format(const InternedString& s, std::format_context& ctx) const {
+        return std::formatter<std::string>::format(s.str(), ctx);
+    }
+};
@@ -10,6 +10,8 @@
 #include "SpawnManager.hpp"
 #include "Effect.hpp"
 #include "BossHealthBar.hpp"
+#include "CollisionGrid.hpp"
+#include "SpriteBatch.hpp"
 
 class Map;
 
@@ -23,7 +25,6 @@ public:
 	int removeAll(const CardInfo& card);
 	void clear();
 	bool findSquareAndPlace(const CardInfo& card);
-	void updateTowerBuff();
 
 	void update();
 	void tick();
@@ -32,6 +33,7 @@ public:
 	bool isEmpty(sf::Vector2i square) const;
 	bool isPlaceable(sf::Vector2i square, const CardInfo& card) const;
 	bool containsTower(const CardInfo& card) const;
+	uint64_t getPlacementVersion() const { return m_placementVersion; }  // Bumped by setCard and removeCard
 
 public:
 	static sf::Vector2i getSquare(sf::Vector2f position);
@@ -54,27 +56,10 @@ private:
 	SharedInfo* m_info;
 	std::array<std::array<std::unique_ptr<Tower>, MAP_WIDTH>, MAP_HEIGHT> m_map;
 
-	bool m_buffUpdated = false;
+	uint64_t m_buffEpoch = 0;  // Buff manager epoch the card description was built for
+	uint64_t m_placementVersion = 0;
 };
 
-inline void to_json(json& j, const MapInfo& m) {
-    j["towers"] = json::array();
-
-    for (int x = 0; x < MAP_HEIGHT; x++) {
-        for (int y = 0; y < MAP_WIDTH; y++) {
-            sf::Vector2i square{x, y};
-            const Tower* tower = m.getTower(square);
-            if (!tower) continue;
-
-            j["towers"].push_back({
-                { "x", x },
-                { "y", y },
-                { "tower", *tower },
-            });
-        }
-    }
-}
-
 inline void from_json(const json& j, MapInfo& m) {
 	m.clear();
 
@@ -98,6 +83,8 @@ public:
 	Map(SharedInfo* info);
 
 	bool update();
+	void simulate();  // World only, safe to run without a window
+	void step();      // One fixed simulation step
 	void tick();
 	void tickDeadEntities();
 	void collision(Petal& petal, Mob& mob);
@@ -106,11 +93,18 @@ public:
 	const MapInfo& getMapInfo() const { return m_map; }
 	MapInfo& getMapInfo() { return m_map; }
 
-	const std::list<std::unique_ptr<Mob>>& getMobs() const { return m_mobs; }
-	std::list<std::unique_ptr<Mob>>& getMobs() { return m_mobs; }
+	const MobSlots& getMobs() const { return m_mobs; }
+	MobSlots& getMobs() { return m_mobs; }
+
+	const PetalSlots& getPetals() const { return m_petals; }
+	PetalSlots& getPetals() { return m_petals; }
 
-	const std::list<std::unique_ptr<Petal>>& getPetals() const { return m_petals; }
-	std::list<std::unique_ptr<Petal>>& getPetals() { return m_petals; }
+	SpawnManager& getSpawner() { return m_spawner; }
+
+	const CollisionStats& getCollisionStats() const { return m_collisionStats; }
+	void resetCollisionStats() { m_collisionStats = {}; }
+	const BatchStats& getBatchStats() const { return m_batch.getStats(); }
+	void resetBatchStats() { m_batch.resetStats(); }
 
 	friend void from_json(const json& j, Map& m);
 
@@ -118,7 +112,11 @@ private:
 	void handlePress(const sf::Vector2i& square);
 	bool handleRightPress(const sf::Vector2i& square);
 	void handleRelease(const sf::Vector2i& square);
+	void handleTargetModeKey(const sf::Vector2i& square);
 	bool handlePlaceTowerRequest();
+	void updateCardDescription();
+	void updateBossHealthBar();
+	void updateStaticLayers(const sf::RenderTarget& target, const sf::RenderStates& states) const;
 	void draw(sf::RenderTarget& target, sf::RenderStates states) const override;
 
 private:
@@ -134,33 +132,44 @@ private:
 	sf::RectangleShape m_background;
 	mutable sf::RectangleShape m_highlight;
 
-	std::list<std::unique_ptr<Mob>> m_mobs;
-	std::list<std::unique_ptr<Petal>> m_petals;
-	std::list<std::unique_ptr<Entity>> m_deadEntities;
+	MobSlots m_mobs;
+	PetalSlots m_petals;
+	std::list<std::unique_ptr<Mob>> m_deadMobs;      // Playing their death animation
+	std::list<std::unique_ptr<Petal>> m_deadPetals;
 	std::list<std::unique_ptr<Effect>> m_effects;
 	sf::Time m_tickTimer;
+	sf::Time m_stepAccumulator;
 
 	mutable std::vector<Mob*> m_sortedMobs;
+	mutable std::array<std::vector<const Petal*>, (size_t)PetalLayer::Count> m_petalLayers;
+	mutable SpriteBatch m_batch;
+
+	// Background and card backgrounds under the reload overlays, card images over them, at the map's size
+	// on screen. Redrawn only when the placement version or that size changes.
+	mutable sf::RenderTexture m_staticUnder;
+	mutable sf::RenderTexture m_staticOver;
+	mutable std::optional<uint64_t> m_staticVersion;
+	mutable sf::VertexArray m_reloadBars{ sf::PrimitiveType::Triangles };  // Rewritten in place every frame
+
+	// Petal <=> mob broadphase, rebuilt every tick
+	CollisionGrid m_collisionGrid;
+	std::vector<Mob*> m_collisionMobs;
+	std::vector<int> m_collisionCandidates;
+	CollisionStats m_collisionStats;
 
 	SpawnManager m_spawner;
 	
-	std::optional<Mob*> m_trackedBoss;
+	MobHandle m_trackedBoss;
 	BossHealthBar m_bossHealthBar;
 };
 
 
-inline void to_json(json& j, const Map& m) {
-	j["info"] = m.getMapInfo();
-	j["mobs"] = json::array();
-	for (const std::unique_ptr<Mob>& mob : m.getMobs())
-		j["mobs"].push_back(*mob);
-}
-
 inline void from_json(const json& j, Map& m) {
     // // Clear existing data
 	// m.getPetals().clear();
 	// m.getMobs().clear();
-	// m.m_deadEntities.clear();
+	// m.m_deadMobs.clear();
+	// m.m_deadPetals.clear();
 	// m.m_effects.clear();
 
 	if (j.contains("info"))
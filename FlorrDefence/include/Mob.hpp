@@ -1,12 +1,23 @@
 #pragma once
-#include <list>
 #include <SFML/Graphics.hpp>
 #include "Entity.hpp"
 #include "Debuff.hpp"
+#include "SlotMap.hpp"
+#include "ObjectPool.hpp"
+
+class Mob;
+
+using MobSlots = SlotMap<Mob>;
+using MobHandle = SlotHandle<Mob>;
 
 class Mob : public Entity {
 public:
-    static std::unique_ptr<Mob> create(SharedInfo* info, const MobInfo& mob, std::list<std::unique_ptr<Mob>>& mobs);
+    static std::unique_ptr<Mob> create(SharedInfo* info, const MobInfo& mob, MobSlots& mobs);
+
+    // All mob types share one pool, the size passed in is the dynamic type's
+    static void* operator new(size_t size) { return getPool().allocate(size); }
+    static void operator delete(void* ptr, size_t size) { getPool().deallocate(ptr, size); }
+    static ObjectPool& getPool();
 
 public:
     Mob(SharedInfo* info, const MobInfo& mob, float startPosition = 0.f);
@@ -26,16 +37,17 @@ public:
     virtual void onDead() override;
 
     MobInfo getMob() const { return m_mob; }
+    void setPathPosition(float position);  // Moves straight to a point on the path
     Debuff& getDebuff() { return m_debuff; }
     float getPathPosition() const { return m_position; }
 
-    friend void to_json(json& j, const Mob& m);
     friend void from_json(const json& j, Mob& m);
+    friend class Record;
 
 public:
-    const MobAttribs::RarityEntry& getAttribs() const { return MOB_ATTRIBS[m_mob.type][m_mob.rarity]; }
-    const bool hasAttrib(const std::string& name) const { return getAttribs().attribs.contains(name); }
-    const float getAttrib(const std::string& name) const { return getAttribs().attribs.at(name); }
+    const MobAttribs::RarityEntry& getAttribs() const { return *m_attribs; }
+    const bool hasAttrib(Attrib attrib) const { return m_attribs->table.has(attrib); }
+    const float getAttrib(Attrib attrib) const { return m_attribs->table.get(attrib); }
 
 protected:
     inline static const float knockbackThreshold = 0.05f;
@@ -47,17 +59,12 @@ protected:
 
 protected:
     MobInfo m_mob;
+    const MobAttribs::RarityEntry* m_attribs;  // Resolved once, config entries never move
     float m_position = 0.f;
     float m_knockback = 0.f;
     Debuff m_debuff;
 };
 
-inline void to_json(json& j, const Mob& m) {
-    j["card"] = m.getMob();
-    j["hp"] = m.m_hp;
-    j["position"] = m.m_position;
-}
-
 inline void from_json(const json& j, Mob& m) {
     assert(m.getMob() == j.value("card", MobInfo{}));
     m.m_hp = j.value("hp", 0);
@@ -83,7 +90,7 @@ private:
     };
 
 public:
-    HornetMob(SharedInfo* info, const MobInfo& mob, std::list<std::unique_ptr<Mob>>& mobs);
+    HornetMob(SharedInfo* info, const MobInfo& mob, MobSlots& mobs);
 
     void update() override;
 
@@ -95,7 +102,7 @@ private:
     void shoot();
 
 private:
-    std::list<std::unique_ptr<Mob>>& m_mobs;
+    MobSlots& m_mobs;
     sf::Time m_timer;
     float m_currShootInterval = 0.f;
     State m_state = State::Moving;
@@ -174,7 +181,7 @@ private:
     };
 
 public:
-    AntQueenMob(SharedInfo* info, const MobInfo& mob, std::list<std::unique_ptr<Mob>>& mobs);
+    AntQueenMob(SharedInfo* info, const MobInfo& mob, MobSlots& mobs);
 
     void update() override;
 
@@ -188,7 +195,7 @@ private:
     void spawn();
 
 private:
-    std::list<std::unique_ptr<Mob>>& m_mobs;
+    MobSlots& m_mobs;
     sf::Time m_timer;
     float m_currDuration = 0.f;
     State m_state = State::Moving;
@@ -196,13 +203,13 @@ private:
 
 class AntEggMob : public Mob {
 public:
-    AntEggMob(SharedInfo* info, const MobInfo& mob, std::list<std::unique_ptr<Mob>>& mobs, float startPosition = 0.f);
+    AntEggMob(SharedInfo* info, const MobInfo& mob, MobSlots& mobs, float startPosition = 0.f);
 
     void update() override;
 
     void onDead() override;
 
 private:
-    std::list<std::unique_ptr<Mob>>& m_mobs;
+    MobSlots& m_mobs;
     sf::Time m_timer;
 };
@@ -0,0 +1,45 @@
+#pragma once
+#include <vector>
+#include <optional>
+#include <SFML/Graphics.hpp>
+#include "SlotMap.hpp"
+#include "CollisionGrid.hpp"
+
+class Mob;
+
+using MobSlots = SlotMap<Mob>;
+using MobHandle = SlotHandle<Mob>;
+
+// Spatial index of the mobs, rebuilt every step after they move.
+// Queries only visit the grid cells under the search circle, so their cost follows
+// the local mob density instead of the total mob count.
+class MobQuery {
+public:
+    MobQuery();
+
+    void update(const MobSlots& mobs);
+
+    // Queries skip underground mobs unless includeUnderground is set, and write into result
+    std::optional<MobHandle> nearest(sf::Vector2f center, float radius) const;
+    void kNearest(sf::Vector2f center, float radius, int k, std::vector<MobHandle>& result) const;  // Nearest first
+    void withinRadius(sf::Vector2f center, float radius, std::vector<MobHandle>& result,
+                      bool includeUnderground = false) const;  // Mob list order
+
+private:
+    void collect(sf::Vector2f center, float radius, bool includeUnderground) const;
+
+private:
+    inline static const float cellSize = 100.f;  // One map square
+
+    struct Entry {
+        MobHandle handle;
+        const Mob* mob;
+    };
+
+    const MobSlots* m_mobs = nullptr;
+    std::vector<Entry> m_entries;  // Mob list order
+    CollisionGrid m_grid;
+
+    mutable std::vector<int> m_candidates;
+    mutable std::vector<std::pair<float, int>> m_found;  // Distance squared, entry
+};
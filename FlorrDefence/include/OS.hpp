@@ -35,6 +35,9 @@ public:
 
     static void showConsole(bool show);
 
+    // Peak resident set size of this process in bytes, 0 where unsupported
+    static size_t getPeakMemory();
+
 private:
     static std::unique_ptr<pfd::open_file> m_openDialog;
     static std::unique_ptr<pfd::save_file> m_saveDialog;
@@ -0,0 +1,44 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <memory>
+#include <cstddef>
+#include <cstdint>
+
+// Recycles storage for one class hierarchy. Blocks are grouped in 16-byte size classes,
+// each with its own free list, and are carved from chunks so the heap is hit once per chunk.
+// Memory is kept for reuse until the pool is destroyed.
+class ObjectPool {
+public:
+    struct Stats {
+        size_t capacity = 0;          // Blocks owned by the pool
+        size_t inUse = 0;
+        size_t highWater = 0;         // Most blocks in use at once
+        uint64_t allocations = 0;
+        uint64_t heapAllocations = 0; // Chunks requested from the heap
+
+        uint64_t getAllocationsAvoided() const { return allocations - heapAllocations; }
+    };
+
+public:
+    ObjectPool(std::string name, size_t blocksPerChunk = 64);
+
+    void* allocate(size_t size);
+    void deallocate(void* ptr, size_t size);
+
+    const std::string& getName() const { return m_name; }
+    const Stats& getStats() const { return m_stats; }
+
+public:
+    inline static const size_t alignment = 16;
+
+private:
+    void addChunk(size_t sizeClass);
+
+private:
+    std::string m_name;
+    size_t m_blocksPerChunk;
+    std::vector<std::vector<void*>> m_freeLists;  // Indexed by size class
+    std::vector<std::unique_ptr<std::byte[]>> m_chunks;
+    Stats m_stats;
+};
@@ -0,0 +1,66 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <SFML/Graphics.hpp>
+#include "SlotMap.hpp"
+
+class Mob;
+
+using MobSlots = SlotMap<Mob>;
+using MobHandle = SlotHandle<Mob>;
+
+enum class TargetMode {
+    Nearest,
+    First,      // Furthest along the path
+    Last,
+    Strongest   // Most hp left
+};
+
+TargetMode stringToTargetMode(const std::string& str);
+std::string targetModeToString(TargetMode mode);
+
+// Path positions [begin, end] whose point lies within a circle
+struct PathInterval {
+    float begin;
+    float end;
+};
+
+// Mobs sorted by path position, front of the path first. Refreshed after mobs move every step,
+// so targeting only scans the mobs inside a tower's path intervals.
+class PathIndex {
+public:
+    void update(const MobSlots& mobs);
+
+    // Best `count` targets within range of center, best first
+    void query(const std::vector<PathInterval>& intervals, sf::Vector2f center, float range,
+               TargetMode mode, int count, std::vector<MobHandle>& result) const;
+
+public:
+    static sf::Vector2f getPathPoint(float position);
+    static std::vector<PathInterval> computeIntervals(sf::Vector2f center, float range);
+
+    inline static const float minPosition = 0.f;
+    inline static const float maxPosition = 39.f;
+
+private:
+    struct Entry {
+        float position;
+        MobHandle handle;
+        const Mob* mob;
+    };
+
+    const MobSlots* m_mobs = nullptr;
+    std::vector<Entry> m_entries;
+
+    mutable std::vector<std::pair<float, MobHandle>> m_scored;
+};
+
+// Cached intervals of one tower, recomputed only when its range changes (e.g. a reach buff)
+class PathCoverage {
+public:
+    const std::vector<PathInterval>& get(sf::Vector2f center, float range);
+
+private:
+    float m_range = -1.f;
+    std::vector<PathInterval> m_intervals;
+};
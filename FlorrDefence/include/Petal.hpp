@@ -6,13 +6,32 @@
 #include "Entity.hpp"
 #include "Mob.hpp"
 #include "Effect.hpp"
+#include "SlotMap.hpp"
+#include "ObjectPool.hpp"
 
 class MapInfo;
+class Petal;
+
+using PetalSlots = SlotMap<Petal>;
+
+// Draw layers, bottom to top. Set by the petal's constructor so the map can bucket petals without RTTI.
+enum class PetalLayer : uint8_t {
+	Ground,      // Webs, under the mobs
+	Summon,      // Mob petals walking the path
+	Projectile,  // Everything else, lasers included
+
+	Count
+};
 
 class Petal : public Entity {
 public:
 	Petal(SharedInfo* info, const CardInfo& card);
-	Petal(SharedInfo* info, const CardInfo& card, const sf::Texture& texture);  // For summon petal
+	Petal(SharedInfo* info, const CardInfo& card, const TexRegion& region);  // For summon petal
+
+	// All petal types share one pool, the size passed in is the dynamic type's
+	static void* operator new(size_t size) { return getPool().allocate(size); }
+	static void operator delete(void* ptr, size_t size) { getPool().deallocate(ptr, size); }
+	static ObjectPool& getPool();
 
 	virtual void update() {}
 	virtual void applyDebuff(Debuff& debuff) const {}
@@ -23,35 +42,38 @@ public:
 	virtual void onDead() override;
 
 	CardInfo getCard() const { return m_card; }
+	PetalLayer getLayer() const { return m_layer; }
 	int getHp() const { return m_hp; }
 	DamageType getDamageType() const { return TOWER_ATTRIBS.at(m_card.type).damageType; }
 
 	void heal(float percent);
 
 protected:
-	virtual bool hasAttrib(const std::string& name) const { return m_attribs.attribs.find(name) != m_attribs.attribs.end(); }
-	virtual float getAttrib(const std::string& name) const { return m_attribs.attribs.at(name); }
-	virtual float getBuffedAttrib(const std::string& name) const { return m_info->playerState.buff.get(name).apply(getAttrib(name)); }
+	virtual bool hasAttrib(Attrib attrib) const { return m_attribs.table.has(attrib); }
+	virtual float getAttrib(Attrib attrib) const { return m_attribs.table.get(attrib); }
+	const EffectiveStats& getStats() const { return EffectiveStatsCache::get(*m_stats, m_info->playerState.buff); }
 
 protected:
 	const TowerAttribs::RarityEntry& m_attribs;
+	EffectiveStatsCache::Entry* m_stats;  // Shared by every petal of this card
 	CardInfo m_card;
+	PetalLayer m_layer = PetalLayer::Projectile;
 };
 
 class ShootPetal : public Petal {
 public:
-	static std::unique_ptr<ShootPetal> create(SharedInfo* info, const CardInfo& card, sf::Vector2f startPosition, std::list<std::unique_ptr<Mob>>::const_iterator target);
+	static std::unique_ptr<ShootPetal> create(SharedInfo* info, const CardInfo& card, sf::Vector2f startPosition, const MobSlots& mobs, MobHandle target);
 
 public:
-	ShootPetal(SharedInfo* info, const CardInfo& card, sf::Vector2f startPosition, std::list<std::unique_ptr<Mob>>::const_iterator target);
-	ShootPetal(SharedInfo* info, const CardInfo& card);  // For laser
+	ShootPetal(SharedInfo* info, const CardInfo& card, sf::Vector2f startPosition, const MobSlots& mobs, MobHandle target);
+	ShootPetal(SharedInfo* info, const CardInfo& card, const MobSlots& mobs);  // For laser
 
 	virtual void update() override;
 	virtual void updatePosition() override;
 	virtual void onDead() override;
 
 	virtual void lostTarget();
-	void lostTarget(std::list<std::unique_ptr<Mob>>::const_iterator target);
+	Mob* getTarget() const { return m_mobs->get(m_target); }  // nullptr once the target is gone
 
 protected:
 	void updateDirection(float trunSpeed);
@@ -61,7 +83,8 @@ protected:
 
 protected:
 	sf::Vector2f m_startPosition;
-	std::optional<std::list<std::unique_ptr<Mob>>::const_iterator> m_target;
+	const MobSlots* m_mobs;
+	MobHandle m_target;
 	sf::Angle m_direction;
 };
 
@@ -96,15 +119,15 @@ public:
 	virtual int getDamage() const override;
 	virtual int getArmor() const override;
 
-	const MobAttribs::RarityEntry& getMobAttribs() const { return MOB_ATTRIBS[m_mob.type][m_mob.rarity]; }
+	const MobAttribs::RarityEntry& getMobAttribs() const { return *m_mobAttribs; }
 
 protected:
-	bool hasAttrib(const std::string& name) const override { return getMobAttribs().attribs.contains(name); }
-	float getAttrib(const std::string& name) const override { return getMobAttribs().attribs.at(name); }
-	float getBuffedAttrib(const std::string& name) const override { return m_info->playerState.buff.get(name).apply(getAttrib(name)); }
+	bool hasAttrib(Attrib attrib) const override { return m_mobAttribs->table.has(attrib); }
+	float getAttrib(Attrib attrib) const override { return m_mobAttribs->table.get(attrib); }
 
 private:
 	MobInfo m_mob;
+	const MobAttribs::RarityEntry* m_mobAttribs;  // Resolved once, config entries never move
 	float m_position;
 	float m_speedMultiplier;
 };
@@ -127,7 +150,7 @@ private:
 
 class TrianglePetal : public ShootPetal {
 public:
-	TrianglePetal(SharedInfo* info, const CardInfo& card, sf::Vector2f startPosition, std::list<std::unique_ptr<Mob>>::const_iterator target, int adjCount);
+	TrianglePetal(SharedInfo* info, const CardInfo& card, sf::Vector2f startPosition, const MobSlots& mobs, MobHandle target, int adjCount);
 
 	int getDamage() const override;
 
@@ -140,10 +163,10 @@ class LightningPetal : public ShootPetal {
 public:
 	using ShootPetal::ShootPetal;
 
-	void onHit(Mob& mob, std::list<std::unique_ptr<Mob>>& mobs, std::list<std::unique_ptr<Effect>>& effects);
+	void onHit(Mob& mob, MobSlots& mobs, std::list<std::unique_ptr<Effect>>& effects);
 
 private:
-	std::vector<std::list<std::unique_ptr<Mob>>::iterator> getTargets(std::list<std::unique_ptr<Mob>>& mobs) const;
+	std::vector<Mob*> getTargets(MobSlots& mobs) const;
 };
 
 class PincerPetal : public ShootPetal {
@@ -181,7 +204,7 @@ public:
 
 class LaserPetal : public ShootPetal {
 public:
-	LaserPetal(SharedInfo* info, const CardInfo& card, sf::Vector2i square, MapInfo& map, const std::list<std::unique_ptr<Mob>>& mobs);
+	LaserPetal(SharedInfo* info, const CardInfo& card, sf::Vector2i square, MapInfo& map, const MobSlots& mobs);
 
 	int getArmor() const override;
 	int getDamage() const override;
@@ -197,10 +220,11 @@ public:
 	sf::Time getDeathDuration() const override { return sf::Time::Zero; }
 
 private:
-	const std::list<std::unique_ptr<Mob>>& m_mobs;
 	MapInfo& m_map;
 	sf::Vector2i m_square;
 	sf::Time m_timer;
+	PathCoverage m_coverage;
+	std::vector<MobHandle> m_candidates;
 };
 
 class ChipPetal : public ShootPetal {
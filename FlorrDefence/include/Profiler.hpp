@@ -0,0 +1,101 @@
+#pragma once
+#include <array>
+#include <vector>
+#include <string_view>
+#include <filesystem>
+#include <chrono>
+#include <cstdint>
+
+enum class ProfilePhase : uint8_t {
+    HandleEvents,
+    Spawner,
+    MobUpdate,
+    TowerUpdate,
+    PetalUpdate,
+    Collision,
+    TowerTick,
+    DeadEntities,
+    MapDraw,
+    UIDraw,
+    RecordSave,
+    Count
+};
+
+std::string_view profilePhaseToString(ProfilePhase phase);
+
+// Time spent per phase, summed over each frame, for the last frameCapacity frames.
+// Disabled, a scoped timer only checks a flag.
+class Profiler {
+public:
+    inline static constexpr size_t frameCapacity = 600;
+    inline static constexpr size_t phaseCount = (size_t)ProfilePhase::Count;
+
+    struct Summary {
+        ProfilePhase phase;
+        double minMs = 0.0;
+        double avgMs = 0.0;
+        double p99Ms = 0.0;
+    };
+
+public:
+    static bool isEnabled() { return s_enabled; }
+    static void setEnabled(bool enabled) { s_enabled = enabled; }
+
+    static void add(ProfilePhase phase, std::chrono::nanoseconds time);
+    static void endFrame();  // Closes the current frame into the ring buffer
+    static void reset();
+
+    static std::chrono::nanoseconds getTotal(ProfilePhase phase);  // Since the last reset, not limited to the ring buffer
+
+    static size_t getFrameCount();
+    static std::vector<Summary> summarize();
+    static void print();
+
+    // CSV holds one row per frame, JSON the summary plus every frame. Chosen by extension.
+    static bool exportToFile(const std::filesystem::path& path);
+
+private:
+    Profiler() = default;
+    static Profiler& getInstance();
+
+    bool exportCsv(std::ostream& os) const;
+    bool exportJson(std::ostream& os) const;
+    template <typename Fn>
+    void forEachFrame(Fn fn) const;  // Oldest first
+
+private:
+    inline static bool s_enabled = false;
+
+    using Frame = std::array<int64_t, phaseCount>;  // Nanoseconds
+
+    Frame m_current{};
+    Frame m_totals{};
+    std::vector<Frame> m_frames;  // Ring buffer
+    size_t m_next = 0;
+};
+
+class ScopedTimer {
+public:
+    explicit ScopedTimer(ProfilePhase phase)
+        : m_phase(phase), m_enabled(Profiler::isEnabled()) {
+        if (m_enabled)
+            m_start = std::chrono::steady_clock::now();
+    }
+
+    ~ScopedTimer() {
+        if (m_enabled)
+            Profiler::add(m_phase, std::chrono::steady_clock::now() - m_start);
+    }
+
+    ScopedTimer(const ScopedTimer&) = delete;
+    ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+private:
+    ProfilePhase m_phase;
+    bool m_enabled;
+    std::chrono::steady_clock::time_point m_start;
+};
+
+#define PROFILE_CONCAT_IMPL(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_IMPL(a, b)
+#define PROFILE_SCOPE(phase) ScopedTimer PROFILE_CONCAT(profileTimer, __LINE__)(phase)
@@ -1,13 +1,34 @@
 #pragma once
 
 #include <filesystem>
+#include <string>
+#include <istream>
+#include <ostream>
+#include <future>
+#include <optional>
+#include <chrono>
 #include <nlohmann/json.hpp>
+#include "RecordJournal.hpp"
 
 class Game;
+class Map;
 
 using nlohmann::json;
 
+enum class RecordFormat {
+	Json,
+	Binary  // See BinaryRecord.hpp
+};
+
 class Record {
+public:
+	struct SaveResult {
+		std::filesystem::path path;
+		bool success = false;
+		std::string error;
+		std::chrono::milliseconds duration{};  // Serialization and write, on the background thread
+	};
+
 public:
 	static Record& instance();
 
@@ -19,9 +40,43 @@ public:
 	bool try_load(Game& game, const std::filesystem::path& path);
 	void save(Game& game, const std::filesystem::path& path);
 
+	// Both save through the journal, see RecordJournal.hpp.
+	// Snapshots the game on the calling thread, serializes and writes it on a background thread.
+	// At most one save is in flight, returns false without saving while one is.
+	bool saveAsync(Game& game, const std::filesystem::path& path);
+	// Result of a finished background save, returned once
+	std::optional<SaveResult> pollSave();
+	bool isSaving() const;
+	void waitForSave() const;
+
+	// The backpack may be left out when the journal doesn't need it
+	static RecordSnapshot capture(Game& game, bool withBackpack = true);
+	// The reverse of capture, on a game that was just reset
+	static void restore(Game& game, const RecordSnapshot& record);
+	// Player and map only, for runs without the shop and talent UI
+	static void restore(SharedInfo& info, Map& map, const RecordSnapshot& record);
+	// Written next to the target and renamed over it, an interrupted save leaves the old record intact
+	static void writeFile(const RecordSnapshot& record, const std::filesystem::path& path);
+
+	// Records ending in .fdr are saved in the binary format, anything else as JSON
+	static RecordFormat getFormat(const std::filesystem::path& path);
+
+	// Either format, detected from the content. Throw on a malformed record.
+	static RecordSnapshot parse(std::istream& is);
+	// The backpack must be present
+	static void write(std::ostream& os, const RecordSnapshot& record, RecordFormat format);
+
+	// Converts between the two formats, the target format follows the target path.
+	// The source journal is replayed, the target is written without one.
+	static bool convert(const std::filesystem::path& from, const std::filesystem::path& to);
+
+public:
+	inline static const std::string binaryExtension = ".fdr";
+
 private:
 	Record() = default;
 	~Record() = default;
 
-	json m_data;
+	RecordJournal m_journal;                // Only touched by the save in flight, or while none is
+	std::future<SaveResult> m_pendingSave;  // From std::async, destroying it waits for the save
 };
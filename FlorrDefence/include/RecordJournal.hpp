@@ -0,0 +1,58 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <optional>
+#include <filesystem>
+#include <cstdint>
+#include <nlohmann/json.hpp>
+#include "RecordSnapshot.hpp"
+
+using nlohmann::json;
+
+// Repeated saves to the same record write only the sections that changed since the previous one,
+// appended to <record>.journal as one frame per save. The record itself is the checkpoint, rewritten
+// in full once the journal outgrows it; loading reads the checkpoint and replays the journal.
+//
+// Journal layout, every field little-endian:
+//   header   char[4] magic "FDRJ", u16 version, u64 checkpoint id
+//   frames   u32 payload size, u32 FNV-1a of the payload, payload
+//   payload  u8 section count, per section: u8 RecordSection, u32 size, the section as MessagePack
+//
+// The checkpoint id is also stored in the record, a journal left over from an older checkpoint is ignored.
+// Replay stops at the first truncated or corrupt frame, a save interrupted while appending is lost whole.
+//
+// The backpack is tracked by version, so an unchanged backpack is not even copied. The other sections are
+// compared with the last saved ones. Tower reload and shop refresh timers alone don't make a section dirty,
+// they are written along with it and with every checkpoint.
+class RecordJournal {
+public:
+	inline static constexpr char magic[4] = { 'F', 'D', 'R', 'J' };
+	inline static constexpr uint16_t version = 1;
+	inline static const std::string extension = ".journal";
+	inline static constexpr uintmax_t minCompactSize = 64 * 1024;  // Below this the journal is never compacted
+
+	static std::filesystem::path getPath(const std::filesystem::path& record);
+
+	// Whether a snapshot saved to this record has to include the backpack
+	bool needsBackpack(const std::filesystem::path& record, uint64_t backpackVersion) const;
+
+	// Appends the dirty sections, or writes a checkpoint.
+	// Throws on failure, the next save then writes a checkpoint.
+	void save(RecordSnapshot snapshot, const std::filesystem::path& record);
+	void reset();  // The next save writes a checkpoint
+
+	// Applies the journal of the record at path to the record read from it. Returns the number of saves replayed.
+	static size_t replay(RecordSnapshot& record, const std::filesystem::path& path);
+
+private:
+	void writeCheckpoint();
+	void append(const std::vector<RecordSection>& sections);
+
+private:
+	std::optional<RecordSnapshot> m_saved;  // Complete, as last saved
+	std::filesystem::path m_record;
+	uint64_t m_checkpointId = 0;
+	uintmax_t m_checkpointSize = 0;
+	uintmax_t m_journalSize = 0;  // Bytes known to be valid, a torn tail past it is cut before appending
+};
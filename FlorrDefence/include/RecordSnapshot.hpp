@@ -0,0 +1,169 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <optional>
+#include <unordered_map>
+#include <SFML/System.hpp>
+#include <nlohmann/json.hpp>
+#include "SharedInfo.hpp"
+#include "PathIndex.hpp"
+
+using nlohmann::json;
+
+// Parts of a record that are saved and journaled independently
+enum class RecordSection : uint8_t {
+	Player,    // PlayerState without the backpack
+	Backpack,
+	Towers,    // MapInfo
+	Mobs,      // Map
+	Shop,
+	Talent,
+	Count
+};
+
+std::string_view recordSectionToString(RecordSection section);
+
+// Puts a section, as returned by RecordSnapshot::getSection, in its place in a record
+void applyRecordSection(json& record, RecordSection section, json value);
+
+// Everything a record holds, copied out of the game on the main thread, or read from a record file.
+// Owns no pointers into the game, so it can be serialized on another thread.
+struct RecordSnapshot {
+	struct Player {
+		int hpLimit = 0;
+		int hp = 0;
+		int shield = 0;
+		int xp = 0;
+		int bodyDamage = 0;
+		int level = 0;
+		int64_t coin = 0;
+		int talent = 0;
+
+		bool operator==(const Player& other) const = default;
+	};
+
+	struct Tower {
+		sf::Vector2i square;
+		CardInfo card;
+		sf::Time reloadTimer;
+		std::optional<TargetMode> targetMode;  // Only for towers that have one
+	};
+
+	struct Mob {
+		MobInfo card;
+		int hp = 0;
+		float position = 0.f;
+
+		bool operator==(const Mob& other) const = default;
+	};
+
+	struct Shop {
+		std::vector<std::string> products;
+		std::unordered_map<std::string, int> productCountCache;
+		sf::Time refreshTimer;
+
+		// Same products and counts, the refresh timer is not compared
+		bool hasSameStock(const Shop& other) const {
+			return products == other.products && productCountCache == other.productCountCache;
+		}
+	};
+
+	Player player;
+	std::optional<BackpackInfo> backpack;  // Left out when the journal already has this version
+	uint64_t backpackVersion = 0;          // Of the backpack as saved, see setBackpack
+	std::vector<Tower> towers;
+	std::vector<Mob> mobs;
+	std::unordered_map<std::string, Shop> shops;  // By rarity
+	std::vector<int> talentNodes;
+	uint64_t checkpointId = 0;             // Journal checkpoint the record was written as, 0 for none
+
+	// Copies the live backpack when withBackpack, and always while a card is dragged: the card goes back
+	// into the copy, which then has a version of its own. Dropping the card doesn't change the live version,
+	// so a save after the drop still sees a different backpack and captures it again.
+	void setBackpack(const BackpackInfo& live, bool withBackpack, const std::optional<CardInfo>& dragged);
+
+	// JSON of one section, as it appears in the record
+	json getSection(RecordSection section) const;
+	// Reads what getSection returned
+	void setSection(RecordSection section, const json& value);
+	// Moves one section over, leaving it unspecified in other
+	void takeSection(RecordSection section, RecordSnapshot& other);
+};
+
+// Same layout the from_json functions of PlayerState, Map, Shop and Talent read
+
+inline void to_json(json& j, const RecordSnapshot::Player& p) {
+	j = {
+		{ "hpLimit",        p.hpLimit },
+		{ "hp",             p.hp },
+		{ "shield",         p.shield },
+		{ "xp",             p.xp },
+		{ "bodyDamage",     p.bodyDamage },
+		{ "level",          p.level },
+		{ "coin",           p.coin },
+		{ "talent",         p.talent }
+	};
+}
+
+inline void from_json(const json& j, RecordSnapshot::Player& p) {
+	p.hpLimit = j.value("hpLimit", 0);
+	p.hp = j.value("hp", 0);
+	p.shield = j.value("shield", 0);
+	p.xp = j.value("xp", 0);
+	p.bodyDamage = j.value("bodyDamage", 0);
+	p.level = j.value("level", 0);
+	p.coin = j.value("coin", int64_t{ 0 });
+	p.talent = j.value("talent", 0);
+}
+
+inline void to_json(json& j, const RecordSnapshot::Tower& t) {
+	j["x"] = t.square.x;
+	j["y"] = t.square.y;
+
+	json& tower = j["tower"];
+	tower["card"] = t.card;
+	tower["reload_timer"] = t.reloadTimer.asSeconds();
+	if (t.targetMode)
+		tower["target_mode"] = targetModeToString(*t.targetMode);
+}
+
+inline void from_json(const json& j, RecordSnapshot::Tower& t) {
+	t.square = { j.at("x").get<int>(), j.at("y").get<int>() };
+
+	const json& tower = j.at("tower");
+	t.card = tower.at("card").get<CardInfo>();
+	t.reloadTimer = sf::seconds(tower.value("reload_timer", 0.f));
+	if (auto it = tower.find("target_mode"); it != tower.end())
+		t.targetMode = stringToTargetMode(it->get<std::string>());
+}
+
+inline void to_json(json& j, const RecordSnapshot::Mob& m) {
+	j["card"] = m.card;
+	j["hp"] = m.hp;
+	j["position"] = m.position;
+}
+
+inline void from_json(const json& j, RecordSnapshot::Mob& m) {
+	m.card = j.at("card").get<MobInfo>();
+	m.hp = j.value("hp", 0);
+	m.position = j.value("position", 0.f);
+}
+
+inline void to_json(json& j, const RecordSnapshot::Shop& s) {
+	j["products"] = s.products;
+	j["product_count_cache"] = s.productCountCache;
+	j["refresh_timer"] = s.refreshTimer.asSeconds();
+}
+
+inline void from_json(const json& j, RecordSnapshot::Shop& s) {
+	j.at("products").get_to(s.products);
+	j.at("product_count_cache").get_to(s.productCountCache);
+	s.refreshTimer = sf::seconds(j.at("refresh_timer").get<float>());
+}
+
+// The backpack must be present
+void to_json(json& j, const RecordSnapshot& s);
+// Sections missing from the record are left empty, the backpack unset
+void from_json(const json& j, RecordSnapshot& s);
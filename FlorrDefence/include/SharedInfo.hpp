@@ -4,12 +4,16 @@
 #include <unordered_map>
 #include <set>
 #include <array>
+#include <atomic>
 #include <SFML/Graphics.hpp>
 #include <nlohmann/json.hpp>
 #include "DraggedCard.hpp"
 #include "CardDescription.hpp"
 #include "Buff.hpp"
 #include "Constants.hpp"
+#include "PathIndex.hpp"
+#include "MobQuery.hpp"
+#include "EffectiveStats.hpp"
 
 using nlohmann::json;
 
@@ -21,14 +25,21 @@ public:
     int getRarityCount(const std::string& rarity) const;
     int getTypeCount(const std::string& type) const;
     void add(const CardStackInfo& stack);
+    const std::map<CardInfo, int>& getCounts() const { return m_count; }  // Cards counted down to 0 included
+
+    // Changes with every add, unique across backpacks so a saved version never matches another backpack
+    uint64_t getVersion() const { return m_version; }
 
     friend void to_json(json& j, const BackpackInfo& b);
     friend void from_json(const json& j, BackpackInfo& b);
 
 private:
+    inline static std::atomic<uint64_t> s_lastVersion = 0;
+
     std::map<CardInfo, int> m_count;
     std::unordered_map<std::string, int> m_rarityCount;
     std::unordered_map<std::string, int> m_typeCount;
+    uint64_t m_version = 0;
 };
 
 struct Counter {
@@ -77,7 +88,6 @@ struct PlayerState {
     int talent = 0;
     Accum acc;
     BackpackInfo backpack;
-    BuffGroup towerBuff;
     BuffGroup talentBuff;
     BuffGroup buff;
     BuffManager buffManager;
@@ -101,20 +111,6 @@ struct PlayerState {
     void applyHealValueBuff(sf::Time dt);
 };
 
-inline void to_json(json& j, const PlayerState& p) {
-    j = {
-        { "hpLimit",        p.hpLimit },
-        { "hp",             p.hp },
-        { "shield",         p.shield },
-        { "xp",             p.xp },
-        { "bodyDamage",     p.bodyDamage },
-        { "level",          p.level },
-        { "coin",           p.coin },
-        { "talent",         p.talent },
-        { "backpack",       p.backpack }
-    };
-}
-
 inline void from_json(const json& j, PlayerState& p) {
     p.init();
 
@@ -151,10 +147,15 @@ struct InputInfo {
 struct SharedInfo {
     sf::Vector2f mouseWorldPosition;
     InputInfo input;
-    sf::Time dt;
+    sf::Time dt;              // Fixed simulation step
+    sf::Time frameDt;         // Real frame time, for UI animation
+    float interpolation = 1.f;  // Render position between the previous and current step
     PlayerState playerState;
     std::array<std::array<DefencePetal*, 10>, 11> defencePetalMap = {};
     std::array<std::array<bool, 10>, 11> laserMap = {};
+    PathIndex pathIndex;  // Mobs by path position, refreshed every step
+    MobQuery mobQuery;    // Mobs by map position, refreshed every step
+    EffectiveStatsCache effectiveStats;
     Counter counter;
     
     std::optional<DraggedCard> draggedCard;
@@ -166,4 +167,5 @@ struct SharedInfo {
     
     void init();
     bool update(const sf::RenderWindow& window);
+    bool update(sf::Time elapsed);  // Headless, no mouse or keyboard state
 };
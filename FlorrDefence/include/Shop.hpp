@@ -48,9 +48,14 @@ public:
 	std::unordered_map<std::string, int>& getCache() { return m_productCountCache; }
 	const std::unordered_map<std::string, int>& getCache() const { return m_productCountCache; }
 	sf::Time getRemainingTime() const;
+	// Same products and counts, the refresh timer is not compared
+	bool hasSameStock(const ShopInfo& other) const {
+		return m_products == other.m_products && m_productCountCache == other.m_productCountCache;
+	}
 
 	friend void to_json(json& j, const ShopInfo& s);
 	friend void from_json(const json& j, ShopInfo& s);
+	friend class Record;
 
 private:
 	void refresh();
@@ -88,8 +93,10 @@ public:
 
 	void updateComponents() const;
 
-	friend void to_json(json& j, const Shop& s);
+	const std::unordered_map<std::string, ShopInfo>& getShops() const { return m_shops; }
+
 	friend void from_json(const json& j, Shop& s);
+	friend class Record;
 
 private:
 	void draw(sf::RenderTarget& target, sf::RenderStates states) const override;
@@ -119,11 +126,6 @@ private:
 	mutable bool m_updated = false;
 };
 
-inline void to_json(json& j, const Shop& s) {
-	for (const auto& [rarity, shop] : s.m_shops)
-		j[rarity] = shop;
-}
-
 inline void from_json(const json& j, Shop& s) {
 	for (auto& [rarity, shop] : s.m_shops)
 		j[rarity].get_to(shop);
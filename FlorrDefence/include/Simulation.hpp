@@ -0,0 +1,39 @@
+#pragma once
+#include <filesystem>
+#include <SFML/System.hpp>
+#include "SharedInfo.hpp"
+#include "Map.hpp"
+
+// Runs the map without a window, render target or mouse state
+class Simulation {
+public:
+	struct Report {
+		int frames = 0;
+		sf::Time simulated;
+		sf::Time wall;
+
+		float getSpeed() const;  // Simulated seconds per wall second
+	};
+
+public:
+	Simulation();
+
+	bool load(const std::filesystem::path& path);
+	void start();
+	void step(sf::Time dt);
+	Report run(sf::Time duration, sf::Time dt);
+
+	const SharedInfo& getInfo() const { return m_info; }
+	SharedInfo& getInfo() { return m_info; }
+	const Map& getMap() const { return m_map; }
+	Map& getMap() { return m_map; }
+	sf::Time getSimulatedTime() const { return m_simulated; }
+
+private:
+	void applyTalents(const std::vector<int>& nodes);
+
+private:
+	SharedInfo m_info;
+	Map m_map;
+	sf::Time m_simulated;
+};
@@ -0,0 +1,147 @@
+#pragma once
+#include <vector>
+#include <memory>
+#include <cstdint>
+#include <cstddef>
+#include <type_traits>
+
+// Refers to an element of a SlotMap, goes stale once the element is erased
+template <typename T>
+struct SlotHandle {
+    inline static constexpr uint32_t invalidIndex = UINT32_MAX;
+
+    uint32_t index = invalidIndex;
+    uint32_t generation = 0;
+
+    bool isValid() const { return index != invalidIndex; }
+    bool operator==(const SlotHandle& other) const = default;
+};
+
+// Owns elements in a contiguous vector kept in insertion order.
+// Handles are checked against a per-slot generation, so a stale handle is detected in O(1).
+// Like std::list, elements appended while iterating are still visited by the running loop.
+template <typename T>
+class SlotMap {
+public:
+    using Handle = SlotHandle<T>;
+
+    struct Sentinel {};
+
+    template <bool Const>
+    class Iterator {
+    public:
+        using Container = std::conditional_t<Const, const SlotMap, SlotMap>;
+        using Reference = std::conditional_t<Const, const std::unique_ptr<T>&, std::unique_ptr<T>&>;
+
+        Iterator(Container* map, size_t index) : m_map(map), m_index(index) {}
+
+        Reference operator*() const { return m_map->m_values[m_index]; }
+        auto operator->() const { return &m_map->m_values[m_index]; }
+        Iterator& operator++() { m_index++; return *this; }
+        Iterator operator++(int) { Iterator old = *this; m_index++; return old; }
+
+        bool operator==(const Iterator& other) const { return m_index == other.m_index; }
+        bool operator==(Sentinel) const { return m_index >= m_map->m_values.size(); }  // Size is read on every check
+
+        size_t getIndex() const { return m_index; }
+        Handle getHandle() const { return m_map->getHandle(m_index); }
+
+    private:
+        Container* m_map;
+        size_t m_index;
+    };
+
+    using iterator = Iterator<false>;
+    using const_iterator = Iterator<true>;
+
+public:
+    Handle push_back(std::unique_ptr<T> value) {
+        uint32_t slot;
+        if (!m_freeSlots.empty()) {
+            slot = m_freeSlots.back();
+            m_freeSlots.pop_back();
+        }
+        else {
+            slot = (uint32_t)m_slots.size();
+            m_slots.push_back({});
+        }
+
+        m_slots[slot].dense = (uint32_t)m_values.size();
+        m_values.push_back(std::move(value));
+        m_denseSlots.push_back(slot);
+
+        return { slot, m_slots[slot].generation };
+    }
+
+    // nullptr if the handle is stale
+    T* get(Handle handle) const {
+        if (!contains(handle))
+            return nullptr;
+        return m_values[m_slots[handle.index].dense].get();
+    }
+
+    bool contains(Handle handle) const {
+        return handle.index < m_slots.size() && m_slots[handle.index].generation == handle.generation
+            && m_slots[handle.index].dense != freeDense;
+    }
+
+    Handle getHandle(size_t index) const {
+        uint32_t slot = m_denseSlots[index];
+        return { slot, m_slots[slot].generation };
+    }
+
+    // Stable, keeps the insertion order. pred may append new elements, they are checked too.
+    // pred receives the owning pointer and may move it out before returning true.
+    template <typename Pred>
+    void eraseIf(Pred pred) {
+        size_t kept = 0;
+        for (size_t i = 0; i < m_values.size(); i++) {
+            if (pred(m_values[i])) {
+                uint32_t slot = m_denseSlots[i];
+                m_slots[slot].generation++;
+                m_slots[slot].dense = freeDense;
+                m_freeSlots.push_back(slot);
+                m_values[i].reset();
+                continue;
+            }
+
+            if (kept != i) {
+                m_values[kept] = std::move(m_values[i]);
+                m_denseSlots[kept] = m_denseSlots[i];
+                m_slots[m_denseSlots[kept]].dense = (uint32_t)kept;
+            }
+            kept++;
+        }
+
+        m_values.resize(kept);
+        m_denseSlots.resize(kept);
+    }
+
+    void clear() {
+        eraseIf([](const std::unique_ptr<T>&) { return true; });
+    }
+
+    size_t size() const { return m_values.size(); }
+    bool empty() const { return m_values.empty(); }
+    void reserve(size_t capacity) { m_values.reserve(capacity); m_denseSlots.reserve(capacity); }
+
+    std::unique_ptr<T>& operator[](size_t index) { return m_values[index]; }
+    const std::unique_ptr<T>& operator[](size_t index) const { return m_values[index]; }
+
+    iterator begin() { return { this, 0 }; }
+    const_iterator begin() const { return { this, 0 }; }
+    Sentinel end() const { return {}; }
+
+private:
+    inline static constexpr uint32_t freeDense = UINT32_MAX;
+
+    struct Slot {
+        uint32_t dense = freeDense;
+        uint32_t generation = 0;
+    };
+
+    std::vector<std::unique_ptr<T>> m_values;  // Dense, insertion order
+    std::vector<uint32_t> m_denseSlots;        // Dense index -> slot
+    std::vector<Slot> m_slots;                 // Slot -> dense index
+    std::vector<uint32_t> m_freeSlots;
+};
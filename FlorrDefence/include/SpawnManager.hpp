@@ -1,11 +1,13 @@
 #pragma once
 
-#include <list>
 #include <random>
 #include "SharedInfo.hpp"
+#include "SlotMap.hpp"
 
 class Mob;
 
+using MobSlots = SlotMap<Mob>;
+
 struct MobTypeEntry {
     MobInfo mob;
     double weight = 1.0;
@@ -38,7 +40,8 @@ public:
 
     void load();
 
-    void update(std::list<std::unique_ptr<Mob>>& mobList);
+    void update(MobSlots& mobList);
+    void setEnabled(bool enabled) { m_enabled = enabled; }  // Disabled, no mobs are spawned
 
 private:
     Stage const* findStage(int level) const;
@@ -51,6 +54,7 @@ private:
     SharedInfo* m_info;
     std::vector<Stage> m_stages;
     size_t m_maxMob = 200;
+    bool m_enabled = true;
 
     // timing
     sf::Time m_spawnTimer;
@@ -0,0 +1,36 @@
+#pragma once
+#include <SFML/Graphics.hpp>
+#include <cstdint>
+#include "TextureAtlas.hpp"
+
+struct BatchStats {
+    int64_t frames = 0;
+    int64_t sprites = 0;    // Also the draw calls it took before batching
+    int64_t drawCalls = 0;
+};
+
+// Collects sprite quads into one vertex array and draws each run of sprites sharing
+// a texture with a single call. Sprites keep the order they were added in:
+// a texture change, or anything drawn straight to the target, has to flush first.
+class SpriteBatch {
+public:
+    // Brightness (0 to 1) is packed into the texture x coordinate in 1/255 steps of this,
+    // for the flash shader to unpack. Has to stay above the width of any batched texture.
+    inline static constexpr float brightnessStride = 4096.f;
+    static_assert(TextureAtlas::pageSize < brightnessStride);
+
+    void begin(sf::RenderTarget& target, sf::RenderStates states);
+    void add(const sf::Sprite& sprite, float brightness = 0.f);
+    void flush();
+
+    const BatchStats& getStats() const { return m_stats; }
+    void countFrame() { m_stats.frames++; }
+    void resetStats() { m_stats = {}; }
+
+private:
+    sf::RenderTarget* m_target = nullptr;
+    sf::RenderStates m_states;
+    const sf::Texture* m_texture = nullptr;
+    sf::VertexArray m_vertices{ sf::PrimitiveType::Triangles };
+    BatchStats m_stats;
+};
@@ -2,29 +2,59 @@
 #include <SFML/Graphics.hpp>
 #include <unordered_map>
 #include <vector>
+#include <cstdint>
+#include "TextureAtlas.hpp"
+
+// One bit per texel, each row padded to whole 64-bit words
+struct BitMask {
+    unsigned width = 0;
+    unsigned height = 0;
+    unsigned wordsPerRow = 0;
+    std::vector<uint64_t> words;
+
+    BitMask() = default;
+    BitMask(unsigned width, unsigned height);
+
+    void set(unsigned x, unsigned y) { words[y * wordsPerRow + (x >> 6)] |= uint64_t{ 1 } << (x & 63); }
+    bool test(unsigned x, unsigned y) const { return (words[y * wordsPerRow + (x >> 6)] >> (x & 63)) & 1; }
+    size_t getMemory() const { return words.size() * sizeof(uint64_t); }
+};
 
 class SpriteCollisionManager {
 public:
     static void load();
-    static sf::FloatRect getTrimmedBounds(const sf::Texture& texture);
+    static sf::FloatRect getTrimmedBounds(const TexRegion& region);  // Local to the region
     static sf::FloatRect getTrimmedBounds(const sf::Sprite& sprite);
     static bool isCollide(const sf::Sprite& a, const sf::Sprite& b);
+    static size_t getMaskMemory();  // Bytes used by all alpha masks, one per texture or atlas page
 
 private:
     SpriteCollisionManager() = default;
     static SpriteCollisionManager& getInstance();
 
-    sf::FloatRect _getTrimmedBounds(const sf::Texture& texture);
-    const std::vector<uint8_t>& _getAlphaMask(const sf::Texture& texture);
+    sf::FloatRect _getTrimmedBounds(const TexRegion& region);
+    const BitMask& _getAlphaMask(const sf::Texture& texture);
     bool _isCollide(const sf::Sprite& a, const sf::Sprite& b);
+    // Both sprites only translated, area in world pixels
+    bool isCollideTranslated(const BitMask& maskA, sf::IntRect subA, const sf::Transform& invA,
+                             const BitMask& maskB, sf::IntRect subB, const sf::Transform& invB,
+                             sf::IntRect area);
+    // Any other pair, tested texel by texel in the frame of a, area in world pixels
+    bool isCollideResampled(const sf::Sprite& a, const BitMask& maskA,
+                            const sf::Sprite& b, const BitMask& maskB, sf::FloatRect area);
 
 private:
     void addTexture(const sf::Texture& texture);
+    void addRegion(const TexRegion& region);
 
 public:
     inline static unsigned char alphaThreshold = 10;
 
 private:
-    std::unordered_map<const sf::Texture*, sf::FloatRect> m_trimmedBounds;
-    std::unordered_map<const sf::Texture*, std::vector<uint8_t>> m_alphaMasks;
+    std::unordered_map<TexRegion, sf::FloatRect> m_trimmedBounds;
+    std::unordered_map<const sf::Texture*, BitMask> m_alphaMasks;
+
+    // Rows of the two masks shifted into line, reused by every translated test
+    std::vector<uint64_t> m_rowA;
+    std::vector<uint64_t> m_rowB;
 };
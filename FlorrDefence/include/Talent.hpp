@@ -79,6 +79,7 @@ public:
 	const std::vector<int>& getActivatedNodes() const { return m_activatedNodes; }
 
 	friend void from_json(const json& j, Talent& t);
+	friend class Record;
 
 private:
 	sf::Vector2f getOffset() const;
@@ -112,12 +113,6 @@ private:
 	bool m_updated = false;
 };
 
-inline void to_json(json& j, const Talent& t) {
-	j = {
-		{ "activated_nodes", t.getActivatedNodes() }
-	};
-}
-
 inline void from_json(const json& j, Talent& t) {
 	if (!j.contains("activated_nodes"))
 		return;
@@ -0,0 +1,43 @@
+#pragma once
+#include <vector>
+#include <memory>
+#include <functional>
+#include <SFML/Graphics.hpp>
+
+// A whole texture, or the sub-rect of an atlas page an image was packed into
+struct TexRegion {
+    const sf::Texture* texture = nullptr;
+    sf::IntRect rect;
+
+    const sf::Texture& getTexture() const { return *texture; }
+    bool operator==(const TexRegion& other) const = default;
+};
+
+template <>
+struct std::hash<TexRegion> {
+    size_t operator()(const TexRegion& region) const {
+        size_t h = std::hash<const void*>()(region.texture);
+        for (int v : { region.rect.position.x, region.rect.position.y, region.rect.size.x, region.rect.size.y })
+            h = h * 31 + std::hash<int>()(v);
+        return h;
+    }
+};
+
+// Packs images into a few large pages at load time, so sprites of different
+// mobs and petals share a texture and can be drawn in one batch
+class TextureAtlas {
+public:
+    inline static constexpr unsigned pageSize = 2048;
+    inline static constexpr unsigned padding = 2;  // Transparent gap between images, against sampling bleed
+
+    size_t add(sf::Image image);  // Returns the id to look the region up with after build()
+    void build();
+
+    const TexRegion& getRegion(size_t id) const { return m_regions.at(id); }
+    size_t getPageCount() const { return m_pages.size(); }
+
+private:
+    std::vector<sf::Image> m_images;
+    std::vector<TexRegion> m_regions;
+    std::vector<std::unique_ptr<sf::Texture>> m_pages;
+};
@@ -127,6 +127,11 @@ inline std::mt19937& globalRNG() {
 	return rng;
 }
 
+// Same seed and same inputs give the same simulation
+inline void seedGlobalRNG(uint32_t seed) {
+	globalRNG().seed(seed);
+}
+
 static inline int randomInt(int low, int high) {
 	std::uniform_int_distribution<int> dis(low, high);
 	return dis(globalRNG());
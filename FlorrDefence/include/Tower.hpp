@@ -17,16 +17,23 @@ public:
 	virtual ~Tower();
 
 	virtual void update() {}
-	virtual void tick(std::list<std::unique_ptr<Petal>>& petals, const std::list<std::unique_ptr<Mob>>& mobs) {}
+	virtual void tick(PetalSlots& petals, const MobSlots& mobs) {}
 	virtual void drawAfterEntities(sf::RenderTarget& target, sf::RenderStates states) const {}
+	void drawCardPart(TowerCard::Part part, sf::RenderTarget& target, sf::RenderStates states) const;
+	void writeReloadQuad(sf::Vertex* quad) const { m_card.writeReloadQuad(quad, getTransform()); }
+
+	virtual bool hasTargetMode() const { return false; }
+	TargetMode getTargetMode() const { return m_targetMode; }
+	void cycleTargetMode();
 
 	void setLength(float length) { m_card.setLength(length); }
 	CardInfo getCard() const { return m_card.getCard(); };
-	float getAttrib(const std::string& name) const { return m_attribs.attribs.at(name); }
-	float getBuffedAttrib(const std::string& name) const { return m_info->playerState.buff.get(name).apply(getAttrib(name)); }
+	sf::Time getReloadTimer() const { return m_reloadTimer; }
+	float getAttrib(Attrib attrib) const { return m_attribs.table.get(attrib); }
+	const EffectiveStats& getStats() const { return EffectiveStatsCache::get(*m_stats, m_info->playerState.buff); }
 
-	friend void to_json(json& j, const Tower& t);
 	friend void from_json(const json& j, Tower& t);
+	friend class Record;
 
 private:
 	void draw(sf::RenderTarget& target, sf::RenderStates states) const;
@@ -34,18 +41,16 @@ private:
 protected:
 	SharedInfo* m_info;
 	const TowerAttribs::RarityEntry& m_attribs;
+	EffectiveStatsCache::Entry* m_stats;
 	TowerCard m_card;
 	sf::Time m_reloadTimer;
+	TargetMode m_targetMode = TargetMode::Nearest;
 };
 
-inline void to_json(json& j, const Tower& t) {
-	j["card"] = t.getCard();
-	j["reload_timer"] = t.m_reloadTimer.asSeconds();
-}
-
 inline void from_json(const json& j, Tower& t) {
 	assert(t.getCard() == j.value("card", MobInfo{}));
 	t.m_reloadTimer = sf::seconds(j.value("reload_timer", 0.f));
+	t.m_targetMode = stringToTargetMode(j.value("target_mode", std::string("nearest")));
 }
 
 class ShootTower : public Tower {
@@ -53,10 +58,17 @@ public:
 	ShootTower(SharedInfo* info, const CardInfo& card);
 
 	virtual void update() override;
-	virtual void tick(std::list<std::unique_ptr<Petal>>& petals, const std::list<std::unique_ptr<Mob>>& mobs) override;
+	virtual void tick(PetalSlots& petals, const MobSlots& mobs) override;
+
+	bool hasTargetMode() const override { return true; }
+
+protected:
+	std::optional<MobHandle> getTarget() const;
+	void queryTargets(int count, std::vector<MobHandle>& result) const;  // Best first, by target mode
 
 protected:
-	std::optional<std::list<std::unique_ptr<Mob>>::const_iterator> getNearestMob(const std::list<std::unique_ptr<Mob>>& mobs) const;
+	mutable PathCoverage m_coverage;
+	mutable std::vector<MobHandle> m_targets;
 };
 
 class DefenceTower : public Tower {
@@ -64,7 +76,7 @@ public:
 	DefenceTower(SharedInfo* info, const CardInfo& card, sf::Vector2i square);
 
 	virtual void update() override;
-	virtual void tick(std::list<std::unique_ptr<Petal>>& petals, const std::list<std::unique_ptr<Mob>>& mobs) override;
+	virtual void tick(PetalSlots& petals, const MobSlots& mobs) override;
 
 protected:
 	sf::Vector2i m_square;
@@ -75,7 +87,7 @@ public:
 	SummonTower(SharedInfo* info, const CardInfo& card);
 
 	virtual void update() override;
-	virtual void tick(std::list<std::unique_ptr<Petal>>& petals, const std::list<std::unique_ptr<Mob>>& mobs) override;
+	virtual void tick(PetalSlots& petals, const MobSlots& mobs) override;
 
 protected:
 	bool ableToSummon();
@@ -87,8 +99,6 @@ public:
 
 	virtual void update() override;
 
-	virtual void applyToBuff();
-
 	bool isActive() const;
 
 protected:
@@ -99,11 +109,7 @@ class MultiShotTower : public ShootTower {
 public:
 	MultiShotTower(SharedInfo* info, const CardInfo& card);
 
-	void tick(std::list<std::unique_ptr<Petal>>& petals, const std::list<std::unique_ptr<Mob>>& mobs) override;
-
-private:
-	std::vector<std::list<std::unique_ptr<Mob>>::const_iterator>
-		getTargets(const std::list<std::unique_ptr<Mob>>& mobs) const;
+	void tick(PetalSlots& petals, const MobSlots& mobs) override;
 };
 
 class WebTower : public DefenceTower {
@@ -118,7 +124,7 @@ public:
 	using DefenceTower::DefenceTower;
 
 	void update() override;
-	void tick(std::list<std::unique_ptr<Petal>>& petals, const std::list<std::unique_ptr<Mob>>& mobs) override;
+	void tick(PetalSlots& petals, const MobSlots& mobs) override;
 };
 
 class ShovelTower : public DefenceTower {
@@ -126,7 +132,7 @@ public:
 	using DefenceTower::DefenceTower;
 
 	void update() override;
-	void tick(std::list<std::unique_ptr<Petal>>& petals, const std::list<std::unique_ptr<Mob>>& mobs) override;
+	void tick(PetalSlots& petals, const MobSlots& mobs) override;
 };
 
 class RoseTower : public BuffTower {
@@ -135,7 +141,7 @@ public:
 
 	void update() override;
 
-	void tick(std::list<std::unique_ptr<Petal>>& petals, const std::list<std::unique_ptr<Mob>>& mobs) override;
+	void tick(PetalSlots& petals, const MobSlots& mobs) override;
 };
 
 class ShellTower : public BuffTower {
@@ -144,7 +150,7 @@ public:
 
 	void update() override;
 
-	void tick(std::list<std::unique_ptr<Petal>>& petals, const std::list<std::unique_ptr<Mob>>& mobs) override;
+	void tick(PetalSlots& petals, const MobSlots& mobs) override;
 };
 
 class CoinTower : public BuffTower {
@@ -153,14 +159,14 @@ public:
 
 	void update() override;
 
-	void tick(std::list<std::unique_ptr<Petal>>& petals, const std::list<std::unique_ptr<Mob>>& mobs) override;
+	void tick(PetalSlots& petals, const MobSlots& mobs) override;
 };
 
 class TriangleTower : public ShootTower {
 public:
 	TriangleTower(SharedInfo* info, const CardInfo& card, sf::Vector2i square, const MapInfo& map);
 
-	void tick(std::list<std::unique_ptr<Petal>>& petals, const std::list<std::unique_ptr<Mob>>& mobs) override;
+	void tick(PetalSlots& petals, const MobSlots& mobs) override;
 
 private:
 	int countAdjacentSameType();
@@ -176,7 +182,7 @@ public:
 
 	void update() override;
 
-	void tick(std::list<std::unique_ptr<Petal>>& petals, const std::list<std::unique_ptr<Mob>>& mobs) override {}
+	void tick(PetalSlots& petals, const MobSlots& mobs) override {}
 
 private:
 	sf::Vector2i m_square;
@@ -187,7 +193,7 @@ class GlassTower : public DefenceTower {
 public:
 	GlassTower(SharedInfo* info, const CardInfo& card, sf::Vector2i square, const MapInfo& map);
 
-	void tick(std::list<std::unique_ptr<Petal>>& petals, const std::list<std::unique_ptr<Mob>>& mobs) override;
+	void tick(PetalSlots& petals, const MobSlots& mobs) override;
 
 private:
 	const MapInfo* m_map;
@@ -199,16 +205,18 @@ public:
 
 	void update() override;
 
-	void tick(std::list<std::unique_ptr<Petal>>& petals, const std::list<std::unique_ptr<Mob>>& mobs) override;
+	void tick(PetalSlots& petals, const MobSlots& mobs) override;
 };
 
 class UraniumTower : public ShootTower {
 public:
 	UraniumTower(SharedInfo* info, const CardInfo& card);
 
+	bool hasTargetMode() const override { return false; }  // Hits everything in range
+
 	void update() override;
 
-	void tick(std::list<std::unique_ptr<Petal>>& petals, const std::list<std::unique_ptr<Mob>>& mobs) override;
+	void tick(PetalSlots& petals, const MobSlots& mobs) override;
 
 	void drawAfterEntities(sf::RenderTarget& target, sf::RenderStates states) const override;
 
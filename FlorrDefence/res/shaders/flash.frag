@@ -0,0 +1,14 @@
+uniform sampler2D texture;
+
+varying float brightness;
+
+void main()
+{
+    // Vertex color carries the flash tint and alpha, modulated as SFML does
+    vec4 modulated = texture2D(texture, gl_TexCoord[0].xy) * gl_Color;
+
+    // Brighten RGB only, leave alpha untouched
+    vec3 brightRGB = mix(modulated.rgb, vec3(1.0), brightness);
+
+    gl_FragColor = vec4(brightRGB, modulated.a);
+}
@@ -0,0 +1,17 @@
+uniform float brightnessStride;  // See SpriteBatch::brightnessStride
+
+varying float brightness;  // 0.0 = normal, 1.0 = fully white
+
+void main()
+{
+    // Brightness is packed into the texture x coordinate in steps of brightnessStride,
+    // so flashing sprites can share a vertex array with the rest
+    vec4 texCoord = gl_MultiTexCoord0;
+    float level = floor(texCoord.x / brightnessStride);
+    texCoord.x -= level * brightnessStride;
+    brightness = level / 255.0;
+
+    gl_Position = gl_ModelViewProjectionMatrix * gl_Vertex;
+    gl_TexCoord[0] = gl_TextureMatrix[0] * texCoord;
+    gl_FrontColor = gl_Color;
+}
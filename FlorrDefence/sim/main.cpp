@@ -0,0 +1,81 @@
+#include <iostream>
+#include <string>
+#include <format>
+#include <optional>
+#include "AssetManager.hpp"
+#include "SpriteCollisionManager.hpp"
+#include "Constants.hpp"
+#include "Simulation.hpp"
+#include "Tools.hpp"
+#include "Profiler.hpp"
+
+// Usage: FlorrDefenceSim [--seconds N] [--dt MS] [--record PATH] [--seed N]
+int main(int argc, char* argv[]) {
+    float seconds = 600.f;
+    float dtMs = 1000.f / 60.f;
+    std::string recordPath;
+    std::optional<uint32_t> seed;
+
+    for (int i = 1; i + 1 < argc; i += 2) {
+        std::string arg = argv[i];
+        if (arg == "--seconds")
+            seconds = std::stof(argv[i + 1]);
+        else if (arg == "--dt")
+            dtMs = std::stof(argv[i + 1]);
+        else if (arg == "--record")
+            recordPath = argv[i + 1];
+        else if (arg == "--seed")
+            seed = (uint32_t)std::stoul(argv[i + 1]);
+        else {
+            std::cerr << "Unknown argument: " << arg << std::endl;
+            return -1;
+        }
+    }
+
+    std::cout << "--- Florr Defence (headless) ---" << std::endl;
+    sf::Clock clock;
+    loadConstants();
+    AssetManager::load();
+    SpriteCollisionManager::load();
+    Profiler::setEnabled(PROFILER_ENABLED);
+    std::cout << "Loading took " << clock.getElapsedTime().asMilliseconds() << "ms" << std::endl;
+
+    // Seed before the simulation is constructed, the spawner takes its seed from the global RNG
+    if (seed)
+        seedGlobalRNG(*seed);
+
+    auto sim = std::make_unique<Simulation>();
+    if (!recordPath.empty() && !sim->load(recordPath))
+        return -1;
+    sim->start();
+
+    Simulation::Report report = sim->run(sf::seconds(seconds), sf::seconds(dtMs / 1000.f));
+
+    const PlayerState& player = sim->getInfo().playerState;
+    std::cout << std::format("Frames:           {}", report.frames) << std::endl;
+    std::cout << std::format("Simulated:        {:.1f}s", report.simulated.asSeconds()) << std::endl;
+    std::cout << std::format("Wall:             {:.3f}s", report.wall.asSeconds()) << std::endl;
+    std::cout << std::format("Speed:            {:.1f} sim s / wall s", report.getSpeed()) << std::endl;
+    std::cout << std::format("Mobs alive:       {}", sim->getMap().getMobs().size()) << std::endl;
+    std::cout << std::format("Player:           level {}, hp {}/{}", player.level, player.hp, player.hpLimit) << std::endl;
+
+    const CollisionStats& collision = sim->getMap().getCollisionStats();
+    if (collision.ticks > 0) {
+        double ticks = (double)collision.ticks;
+        std::cout << std::format("Pairs / tick:     {:.1f} tested, {:.1f} colliding, {:.1f} without broadphase",
+            collision.testedPairs / ticks, collision.collidingPairs / ticks, collision.bruteForcePairs / ticks) << std::endl;
+    }
+
+    for (const ObjectPool* pool : { &Mob::getPool(), &Petal::getPool(), &LightningEffect::getPool() }) {
+        const ObjectPool::Stats& stats = pool->getStats();
+        std::cout << std::format("Pool {:<17} capacity {}, high water {}, {} of {} allocations avoided",
+            pool->getName() + ":", stats.capacity, stats.highWater, stats.getAllocationsAvoided(), stats.allocations) << std::endl;
+    }
+
+    if (Profiler::isEnabled()) {
+        Profiler::print();
+        Profiler::exportToFile(PROFILER_EXPORT_PATH);
+    }
+
+    return 0;
+}
@@ -1,8 +1,13 @@
 #include <iostream>
 #include <cassert>
+#include <unordered_set>
 #include "AssetManager.hpp"
 
-static void buildEntries(TexEntry& node, const std::filesystem::path& path) {
+// Directories under res/images packed into the atlas, the rest (map, icon, ui) stay single textures
+static const std::unordered_set<std::string> ATLAS_DIRS = { "cards", "mobs", "petals" };
+
+static void buildEntries(TexEntry& node, const std::filesystem::path& path, TextureAtlas& atlas, bool pack,
+                         std::vector<std::pair<TexEntry*, size_t>>& packed) {
     for (auto& entry : std::filesystem::directory_iterator(path)) {
         const auto& p = entry.path();
         std::string key = p.stem().string();
@@ -12,7 +17,7 @@ static void buildEntries(TexEntry& node, const std::filesystem::path& path) {
                 continue;
             auto child = std::make_unique<TexEntry>();
             child->isTexture = false;
-            buildEntries(*child, p);
+            buildEntries(*child, p, atlas, pack || ATLAS_DIRS.contains(p.filename().string()), packed);
             node.subs.emplace(p.filename().string(), std::move(child));
         }
         else if (entry.is_regular_file()) {
@@ -20,9 +25,20 @@ static void buildEntries(TexEntry& node, const std::filesystem::path& path) {
             if (ext == ".png" || ext == ".jpg" || ext == ".jpeg") {
                 auto child = std::make_unique<TexEntry>();
                 child->isTexture = true;
-                child->tex = std::make_unique<sf::Texture>();
-                if (!child->tex->loadFromFile(p.string()))
-                    throw std::runtime_error("Texture load failure: " + p.string());
+
+                if (pack) {
+                    sf::Image image;
+                    if (!image.loadFromFile(p.string()))
+                        throw std::runtime_error("Texture load failure: " + p.string());
+                    packed.emplace_back(child.get(), atlas.add(std::move(image)));
+                }
+                else {
+                    child->tex = std::make_unique<sf::Texture>();
+                    if (!child->tex->loadFromFile(p.string()))
+                        throw std::runtime_error("Texture load failure: " + p.string());
+                    child->region = { child->tex.get(), sf::IntRect({ 0, 0 }, sf::Vector2i(child->tex->getSize())) };
+                }
+
                 node.subs.emplace(key, std::move(child));
             }
         }
@@ -30,11 +46,25 @@ static void buildEntries(TexEntry& node, const std::filesystem::path& path) {
 }
 
 static void loadShaders(std::unordered_map<std::string, sf::Shader>& shaders, const std::filesystem::path& path) {
+    // Headless runs (e.g. FlorrDefenceSim) never draw, so missing shader support is not an error
+    if (!sf::Shader::isAvailable())
+        return;
+
     for (auto& entry : std::filesystem::directory_iterator(path)) {
         if (!entry.is_regular_file()) continue;
         std::string name = entry.path().filename().string();
         std::string ext = entry.path().extension().string();
-        if (ext == ".frag") {
+
+        // A .vert and .frag sharing a name are linked into one shader, named without extension
+        std::filesystem::path vertPath = std::filesystem::path(entry.path()).replace_extension(".vert");
+        std::filesystem::path fragPath = std::filesystem::path(entry.path()).replace_extension(".frag");
+        bool paired = std::filesystem::exists(vertPath) && std::filesystem::exists(fragPath);
+
+        if (paired) {
+            if (ext == ".vert")
+                shaders.emplace(entry.path().stem().string(), sf::Shader(vertPath, fragPath));
+        }
+        else if (ext == ".frag") {
             shaders.emplace(name, sf::Shader(entry.path(), sf::Shader::Type::Fragment));
         }
         else if (ext == ".vert") {
@@ -47,7 +77,7 @@ static void loadShaders(std::unordered_map<std::string, sf::Shader>& shaders, co
 }
 
 TexEntry::operator const sf::Texture& () const {
-    assert(isTexture && tex && "Not a texture entry");
+    assert(isTexture && tex && "Not a texture entry, or packed into the atlas");
     return *tex;
 }
 
@@ -59,7 +89,12 @@ const TexEntry& TexEntry::operator[](const std::string& name) const {
 
 AssetManager::AssetManager() {
     m_entry.isTexture = false;
-    buildEntries(m_entry, std::filesystem::path("res/images"));
+    std::vector<std::pair<TexEntry*, size_t>> packed;
+    buildEntries(m_entry, std::filesystem::path("res/images"), m_atlas, false, packed);
+
+    m_atlas.build();
+    for (auto [entry, id] : packed)
+        entry->region = m_atlas.getRegion(id);
     loadShaders(m_shaders, std::filesystem::path("res/shaders"));
 
     if (!m_font.openFromFile("res/fonts/Ubuntu-Bold.ttf"))
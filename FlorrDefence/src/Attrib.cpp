@@ -0,0 +1,94 @@
+#include "Attrib.hpp"
+#include <stdexcept>
+#include <format>
+
+namespace {
+    // Same order as Attrib
+    const std::array<std::string, (size_t)Attrib::Count> attribNames = {
+        "armor",
+        "armor_debuff",
+        "armor_debuff_duration",
+        "bounce_range",
+        "bounces",
+        "copy",
+        "damage",
+        "damage_increase",
+        "damage_increase_rate",
+        "death_heal",
+        "duration",
+        "evasion",
+        "heal",
+        "hp",
+        "knockback",
+        "max_damage_rate",
+        "mob_rarity",
+        "petal_heal",
+        "radius",
+        "range",
+        "reload",
+        "scale",
+        "shield",
+        "slow_down",
+        "slow_down_duration",
+        "speed",
+        "aboveground_duration_high",
+        "aboveground_duration_low",
+        "max_dutation",
+        "move_duration_high",
+        "move_duration_low",
+        "post_shoot_delay",
+        "pre_shoot_delay",
+        "rest_duration",
+        "rest_duration_jitter",
+        "rotation_range",
+        "rotation_speed",
+        "running_duration",
+        "running_duration_jitter",
+        "running_speed",
+        "shoot_interval",
+        "shoot_interval_jitter",
+        "spawn_chance",
+        "spawn_duration_high",
+        "spawn_duration_low",
+        "speed_up_duration",
+        "underground_duration_high",
+        "underground_duration_low",
+    };
+}
+
+const std::string& attribToString(Attrib attrib) {
+    return attribNames[(size_t)attrib];
+}
+
+std::optional<Attrib> stringToAttrib(const std::string& str) {
+    static const std::unordered_map<std::string, Attrib> lookup = [] {
+        std::unordered_map<std::string, Attrib> result;
+        for (size_t i = 0; i < attribNames.size(); i++)
+            result[attribNames[i]] = (Attrib)i;
+        return result;
+    }();
+
+    auto it = lookup.find(str);
+    if (it == lookup.end())
+        return std::nullopt;
+    return it->second;
+}
+
+AttribTable AttribTable::compile(const std::unordered_map<std::string, float>& attribs) {
+    AttribTable table;
+    for (const auto& [name, value] : attribs)
+        if (auto attrib = stringToAttrib(name))
+            table.set(*attrib, value);
+    return table;
+}
+
+float AttribTable::get(Attrib attrib) const {
+    if (!has(attrib))
+        throw std::out_of_range(std::format("attribute '{}' is not set", attribToString(attrib)));
+    return m_values[(size_t)attrib];
+}
+
+void AttribTable::set(Attrib attrib, float value) {
+    m_values[(size_t)attrib] = value;
+    m_present.set((size_t)attrib);
+}
@@ -0,0 +1,419 @@
+#include "BinaryRecord.hpp"
+
+#include <unordered_map>
+#include <array>
+#include <stdexcept>
+#include <format>
+#include <bit>
+#include <cstring>
+#include <optional>
+#include <algorithm>
+
+namespace {
+
+constexpr uint16_t noString = UINT16_MAX;
+constexpr size_t headerSize = 8;
+constexpr size_t sectionEntrySize = 12;
+
+using Tag = std::array<char, 4>;
+
+constexpr Tag stringsTag = { 'S', 'T', 'R', 'S' };
+constexpr Tag playerTag = { 'P', 'L', 'Y', 'R' };
+constexpr Tag mapTag = { 'M', 'A', 'P', ' ' };
+constexpr Tag shopTag = { 'S', 'H', 'O', 'P' };
+constexpr Tag talentTag = { 'T', 'L', 'N', 'T' };
+constexpr Tag checkpointTag = { 'C', 'K', 'P', 'T' };
+
+std::string_view tagToString(const Tag& tag) {
+	return std::string_view(tag.data(), tag.size());
+}
+
+class StringTable {
+public:
+	uint16_t add(const std::string& str) {
+		auto [it, inserted] = m_ids.try_emplace(str, (uint16_t)m_strings.size());
+		if (inserted) {
+			if (m_strings.size() >= noString)
+				throw std::runtime_error("Too many distinct strings for a binary record");
+			m_strings.push_back(str);
+		}
+		return it->second;
+	}
+
+	// Card names repeat the most, looked up by id without hashing the text
+	uint16_t add(const InternedString& str) {
+		if (str.getId() >= m_interned.size())
+			m_interned.resize(str.getId() + 1, noString);
+		uint16_t& id = m_interned[str.getId()];
+		if (id == noString)
+			id = add(str.str());
+		return id;
+	}
+
+	void write(BinaryWriter& w) const {
+		w.u32((uint32_t)m_strings.size());
+		for (const std::string& str : m_strings) {
+			if (str.size() > UINT16_MAX)
+				throw std::runtime_error("String too long for a binary record");
+			w.u16((uint16_t)str.size());
+			w.bytes(str);
+		}
+	}
+
+private:
+	std::unordered_map<std::string, uint16_t> m_ids;
+	std::vector<std::string> m_strings;
+	std::vector<uint16_t> m_interned;  // By InternedString id
+};
+
+class StringList {
+public:
+	void read(BinaryReader& r) {
+		uint32_t count = r.u32();
+		for (uint32_t i = 0; i < count; i++)
+			m_strings.emplace_back(r.bytes(r.u16()));
+		m_interned.resize(m_strings.size());
+	}
+
+	const std::string& get(uint16_t id) const {
+		if (id >= m_strings.size())
+			throw std::runtime_error(std::format("String index {} out of range", id));
+		return m_strings[id];
+	}
+
+	// Interned on first use, once per distinct string
+	InternedString getInterned(uint16_t id) {
+		const std::string& str = get(id);
+		if (!m_interned[id])
+			m_interned[id] = InternedString(str);
+		return *m_interned[id];
+	}
+
+private:
+	std::vector<std::string> m_strings;
+	std::vector<std::optional<InternedString>> m_interned;
+};
+
+uint32_t checkedCount(size_t count) {
+	if (count > UINT32_MAX)
+		throw std::runtime_error("Too many elements for a binary record");
+	return (uint32_t)count;
+}
+
+// Card
+
+void writeCard(BinaryWriter& w, StringTable& strings, const CardInfo& card) {
+	w.u16(strings.add(card.rarity));
+	w.u16(strings.add(card.type));
+}
+
+CardInfo readCard(BinaryReader& r, StringList& strings) {
+	CardInfo card;
+	card.rarity = strings.getInterned(r.u16());
+	card.type = strings.getInterned(r.u16());
+	return card;
+}
+
+// Player
+
+void writePlayer(BinaryWriter& w, StringTable& strings, const RecordSnapshot& s) {
+	const RecordSnapshot::Player& p = s.player;
+	w.i32(p.hpLimit);
+	w.i32(p.hp);
+	w.i32(p.shield);
+	w.i32(p.xp);
+	w.i32(p.bodyDamage);
+	w.i32(p.level);
+	w.i64(p.coin);
+	w.i32(p.talent);
+
+	// Same stacks as the JSON record, which leaves out cards counted down to 0
+	const auto& counts = s.backpack.value().getCounts();
+	w.u32(checkedCount(std::count_if(counts.begin(), counts.end(), [](const auto& e) { return e.second != 0; })));
+	for (const auto& [card, count] : counts) {
+		if (count == 0)
+			continue;
+		writeCard(w, strings, card);
+		w.i32(count);
+	}
+}
+
+void readPlayer(BinaryReader& r, StringList& strings, RecordSnapshot& s) {
+	RecordSnapshot::Player& p = s.player;
+	p.hpLimit = r.i32();
+	p.hp = r.i32();
+	p.shield = r.i32();
+	p.xp = r.i32();
+	p.bodyDamage = r.i32();
+	p.level = r.i32();
+	p.coin = r.i64();
+	p.talent = r.i32();
+
+	BackpackInfo& backpack = s.backpack.emplace();
+	uint32_t count = r.u32();
+	for (uint32_t i = 0; i < count; i++) {
+		CardInfo card = readCard(r, strings);
+		backpack.add({ card, r.i32() });
+	}
+}
+
+// Map
+
+void writeMap(BinaryWriter& w, StringTable& strings, const RecordSnapshot& s) {
+	w.u32(checkedCount(s.towers.size()));
+	for (const RecordSnapshot::Tower& tower : s.towers) {
+		auto [x, y] = tower.square;
+		if (x < 0 || x > UINT8_MAX || y < 0 || y > UINT8_MAX)
+			throw std::runtime_error(std::format("Tower square ({}, {}) out of range", x, y));
+
+		w.u8((uint8_t)x);
+		w.u8((uint8_t)y);
+		writeCard(w, strings, tower.card);
+		w.f32(tower.reloadTimer.asSeconds());
+		w.u16(tower.targetMode ? strings.add(targetModeToString(*tower.targetMode)) : noString);
+	}
+
+	w.u32(checkedCount(s.mobs.size()));
+	for (const RecordSnapshot::Mob& mob : s.mobs) {
+		writeCard(w, strings, mob.card);
+		w.i32(mob.hp);
+		w.f32(mob.position);
+	}
+}
+
+void readMap(BinaryReader& r, StringList& strings, RecordSnapshot& s) {
+	uint32_t towerCount = r.u32();
+	s.towers.reserve(towerCount);
+	for (uint32_t i = 0; i < towerCount; i++) {
+		RecordSnapshot::Tower& tower = s.towers.emplace_back();
+		tower.square.x = r.u8();
+		tower.square.y = r.u8();
+		tower.card = readCard(r, strings);
+		tower.reloadTimer = sf::seconds(r.f32());
+		if (uint16_t mode = r.u16(); mode != noString)
+			tower.targetMode = stringToTargetMode(strings.get(mode));
+	}
+
+	uint32_t mobCount = r.u32();
+	s.mobs.reserve(mobCount);
+	for (uint32_t i = 0; i < mobCount; i++) {
+		RecordSnapshot::Mob& mob = s.mobs.emplace_back();
+		mob.card = readCard(r, strings);
+		mob.hp = r.i32();
+		mob.position = r.f32();
+	}
+}
+
+// Shop
+
+void writeShop(BinaryWriter& w, StringTable& strings, const RecordSnapshot& s) {
+	w.u32(checkedCount(s.shops.size()));
+	for (const auto& [rarity, shop] : s.shops) {
+		w.u16(strings.add(rarity));
+
+		w.u32(checkedCount(shop.products.size()));
+		for (const std::string& product : shop.products)
+			w.u16(strings.add(product));
+
+		w.u32(checkedCount(shop.productCountCache.size()));
+		for (const auto& [product, count] : shop.productCountCache) {
+			w.u16(strings.add(product));
+			w.i32(count);
+		}
+
+		w.f32(shop.refreshTimer.asSeconds());
+	}
+}
+
+void readShop(BinaryReader& r, const StringList& strings, RecordSnapshot& s) {
+	uint32_t shopCount = r.u32();
+	for (uint32_t i = 0; i < shopCount; i++) {
+		RecordSnapshot::Shop& shop = s.shops[strings.get(r.u16())];
+
+		uint32_t productCount = r.u32();
+		shop.products.reserve(productCount);
+		for (uint32_t k = 0; k < productCount; k++)
+			shop.products.push_back(strings.get(r.u16()));
+
+		uint32_t cacheCount = r.u32();
+		for (uint32_t k = 0; k < cacheCount; k++) {
+			const std::string& product = strings.get(r.u16());
+			shop.productCountCache[product] = r.i32();
+		}
+
+		shop.refreshTimer = sf::seconds(r.f32());
+	}
+}
+
+// Talent
+
+void writeTalent(BinaryWriter& w, const RecordSnapshot& s) {
+	w.u32(checkedCount(s.talentNodes.size()));
+	for (int node : s.talentNodes)
+		w.i32(node);
+}
+
+void readTalent(BinaryReader& r, RecordSnapshot& s) {
+	uint32_t count = r.u32();
+	s.talentNodes.reserve(count);
+	for (uint32_t i = 0; i < count; i++)
+		s.talentNodes.push_back(r.i32());
+}
+
+}  // namespace
+
+// BinaryWriter
+
+void BinaryWriter::u16(uint16_t value) {
+	u8((uint8_t)value);
+	u8((uint8_t)(value >> 8));
+}
+
+void BinaryWriter::u32(uint32_t value) {
+	u16((uint16_t)value);
+	u16((uint16_t)(value >> 16));
+}
+
+void BinaryWriter::i64(int64_t value) {
+	u32((uint32_t)value);
+	u32((uint32_t)((uint64_t)value >> 32));
+}
+
+void BinaryWriter::f32(float value) {
+	u32(std::bit_cast<uint32_t>(value));
+}
+
+// BinaryReader
+
+const unsigned char* BinaryReader::take(size_t count) {
+	if (count > m_data.size() - m_pos)
+		throw std::runtime_error("Binary record is truncated");
+	const unsigned char* p = (const unsigned char*)m_data.data() + m_pos;
+	m_pos += count;
+	return p;
+}
+
+uint8_t BinaryReader::u8() {
+	return *take(1);
+}
+
+uint16_t BinaryReader::u16() {
+	const unsigned char* p = take(2);
+	return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+uint32_t BinaryReader::u32() {
+	const unsigned char* p = take(4);
+	return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+int64_t BinaryReader::i64() {
+	uint64_t low = u32();
+	uint64_t high = u32();
+	return (int64_t)(low | (high << 32));
+}
+
+float BinaryReader::f32() {
+	return std::bit_cast<float>(u32());
+}
+
+std::string_view BinaryReader::bytes(size_t count) {
+	return std::string_view((const char*)take(count), count);
+}
+
+// BinaryRecord
+
+bool BinaryRecord::isBinary(std::string_view bytes) {
+	return bytes.size() >= sizeof(magic) && std::memcmp(bytes.data(), magic, sizeof(magic)) == 0;
+}
+
+std::string BinaryRecord::encode(const RecordSnapshot& record) {
+	StringTable strings;
+	std::vector<std::pair<Tag, BinaryWriter>> sections;
+
+	auto addSection = [&](const Tag& tag, auto write) {
+		sections.emplace_back(tag, BinaryWriter());
+		write(sections.back().second);
+	};
+
+	addSection(playerTag, [&](BinaryWriter& w) { writePlayer(w, strings, record); });
+	addSection(mapTag, [&](BinaryWriter& w) { writeMap(w, strings, record); });
+	addSection(shopTag, [&](BinaryWriter& w) { writeShop(w, strings, record); });
+	addSection(talentTag, [&](BinaryWriter& w) { writeTalent(w, record); });
+	if (record.checkpointId != 0)
+		addSection(checkpointTag, [&](BinaryWriter& w) { w.i64((int64_t)record.checkpointId); });
+
+	// Built last, every other section adds to it, but stored first
+	BinaryWriter stringSection;
+	strings.write(stringSection);
+	sections.insert(sections.begin(), { stringsTag, std::move(stringSection) });
+
+	BinaryWriter out;
+	out.bytes(std::string_view(magic, sizeof(magic)));
+	out.u16(version);
+	out.u16((uint16_t)sections.size());
+
+	size_t offset = headerSize + sections.size() * sectionEntrySize;
+	for (auto& [tag, section] : sections) {
+		if (offset + section.size() > UINT32_MAX)
+			throw std::runtime_error("Binary record larger than 4 GiB");
+		out.bytes(tagToString(tag));
+		out.u32((uint32_t)offset);
+		out.u32((uint32_t)section.size());
+		offset += section.size();
+	}
+
+	for (auto& [_, section] : sections)
+		out.bytes(section.data());
+
+	return std::move(out.data());
+}
+
+RecordSnapshot BinaryRecord::decode(std::string_view bytes) {
+	if (!isBinary(bytes))
+		throw std::runtime_error("Not a binary record");
+
+	BinaryReader header(bytes);
+	header.bytes(sizeof(magic));
+
+	uint16_t fileVersion = header.u16();
+	if (fileVersion > version)
+		throw std::runtime_error(std::format("Binary record version {} is newer than the supported version {}", fileVersion, version));
+
+	std::unordered_map<std::string_view, std::string_view> sections;
+	uint16_t sectionCount = header.u16();
+	for (uint16_t i = 0; i < sectionCount; i++) {
+		std::string_view tag = header.bytes(4);
+		uint32_t offset = header.u32();
+		uint32_t size = header.u32();
+		if (offset > bytes.size() || size > bytes.size() - offset)
+			throw std::runtime_error(std::format("Section '{}' lies outside the record", tag));
+		sections[tag] = bytes.substr(offset, size);
+	}
+
+	StringList strings;
+	if (sections.contains(tagToString(stringsTag))) {
+		BinaryReader r(sections[tagToString(stringsTag)]);
+		strings.read(r);
+	}
+
+	RecordSnapshot record;
+
+	auto readSection = [&](const Tag& tag, auto read) {
+		auto it = sections.find(tagToString(tag));
+		if (it == sections.end())
+			return;
+		BinaryReader r(it->second);
+		read(r);
+		if (!r.atEnd())
+			throw std::runtime_error(std::format("Section '{}' has trailing data", tagToString(tag)));
+	};
+
+	readSection(playerTag, [&](BinaryReader& r) { readPlayer(r, strings, record); });
+	readSection(mapTag, [&](BinaryReader& r) { readMap(r, strings, record); });
+	readSection(shopTag, [&](BinaryReader& r) { readShop(r, strings, record); });
+	readSection(talentTag, [&](BinaryReader& r) { readTalent(r, record); });
+	readSection(checkpointTag, [&](BinaryReader& r) { record.checkpointId = (uint64_t)r.i64(); });
+
+	return record;
+}
@@ -0,0 +1,143 @@
+#include "Buff.hpp"
+#include <unordered_map>
+#include <stdexcept>
+#include <algorithm>
+
+BuffType stringToBuffType(const std::string& str) {
+	static const std::unordered_map<std::string, BuffType> lookup = {
+		{"speed", BuffType::Speed},
+		{"body_damage", BuffType::BodyDamage},
+		{"heal_value", BuffType::HealValue},
+		{"overheal", BuffType::Overheal},
+		{"reload", BuffType::Reload},
+		{"damage", BuffType::Damage},
+		{"summoner", BuffType::Summoner},
+		{"reach", BuffType::Reach},
+		{"luck", BuffType::Luck},
+		{"health", BuffType::Health},
+		{"evasion", BuffType::Evasion},
+		{"damage_reduction", BuffType::DamageReduction},
+		{"mob_spawn_rate", BuffType::MobSpawnRate},
+		{"shop", BuffType::Shop},
+		{"antennae", BuffType::Antennae},
+		{"yin_yang", BuffType::YinYang}
+	};
+
+	auto it = lookup.find(str);
+	if (it == lookup.end())
+		throw std::runtime_error("Unknown buff name: " + str);
+	return it->second;
+}
+
+// BuffManager
+namespace {
+	const InternedString ANTENNAE = "antennae";
+}
+
+void BuffManager::add(const CardInfo& card, sf::Vector2i square) {
+	TypeEntry& entry = m_types[card.type];
+	entry.flower = FLOWER_BUFF_TOWERS.contains(card.type);
+	entry.candidates.insert({ getRarityLevel(card.rarity), square, card.rarity });
+
+	if (card.type == ANTENNAE)
+		updateAntennaeLevel();
+	updateWinner(card.type, entry);
+}
+
+void BuffManager::remove(const CardInfo& card, sf::Vector2i square) {
+	auto it = m_types.find(card.type);
+	if (it == m_types.end())
+		return;
+
+	TypeEntry& entry = it->second;
+	entry.candidates.erase({ getRarityLevel(card.rarity), square, card.rarity });
+
+	if (card.type == ANTENNAE)
+		updateAntennaeLevel();
+	updateWinner(card.type, entry);
+}
+
+void BuffManager::setTalentAntennaeLevel(int level) {
+	if (level == m_talentAntennaeLevel)
+		return;
+
+	m_talentAntennaeLevel = level;
+	updateAntennaeLevel();
+}
+
+void BuffManager::clear() {
+	m_types.clear();
+	m_antennaeLevel = m_talentAntennaeLevel;
+	m_buff.reset();
+	m_epoch++;
+}
+
+bool BuffManager::find(const CardInfo& card, sf::Vector2i square) const {
+	auto it = m_types.find(card.type);
+	if (it == m_types.end() || !it->second.winner)
+		return false;
+	return it->second.winner->square == square;
+}
+
+void BuffManager::updateWinner(InternedString type, TypeEntry& entry) {
+	std::optional<Candidate> winner;
+	for (const Candidate& candidate : entry.candidates) {
+		if (!entry.flower || candidate.level <= m_antennaeLevel) {
+			winner = candidate;
+			break;
+		}
+	}
+
+	bool same = winner.has_value() == entry.winner.has_value()
+		&& (!winner || (winner->square == entry.winner->square && winner->level == entry.winner->level));
+	if (same)
+		return;
+
+	// Buff types touched by the old or the new winner
+	std::vector<BuffType> dirty;
+	for (const auto& [buffType, value] : entry.contributions)
+		dirty.push_back(buffType);
+
+	entry.winner = winner;
+	entry.contributions.clear();
+	if (winner) {
+		for (const auto& [name, value] : TOWER_ATTRIBS.at(type)[winner->rarity].attribs) {
+			if (name.find("_buff") != std::string::npos) {
+				BuffType buffType = stringToBuffType(name.substr(0, name.size() - 5));
+				entry.contributions.emplace_back(buffType, value);
+				dirty.push_back(buffType);
+			}
+		}
+	}
+
+	std::sort(dirty.begin(), dirty.end());
+	dirty.erase(std::unique(dirty.begin(), dirty.end()), dirty.end());
+	for (BuffType buffType : dirty)
+		recompute(buffType);
+
+	m_epoch++;
+}
+
+void BuffManager::updateAntennaeLevel() {
+	int level = m_talentAntennaeLevel;
+	auto it = m_types.find(ANTENNAE);
+	if (it != m_types.end() && !it->second.candidates.empty())
+		level = std::max(level, it->second.candidates.begin()->level);
+
+	if (level == m_antennaeLevel)
+		return;
+
+	// Flower towers may have gained or lost their eligibility
+	m_antennaeLevel = level;
+	for (auto& [type, entry] : m_types)
+		if (entry.flower)
+			updateWinner(type, entry);
+}
+
+void BuffManager::recompute(BuffType buffType) {
+	m_buff.set(buffType);
+	for (const auto& [type, entry] : m_types)
+		for (const auto& [contributionType, value] : entry.contributions)
+			if (contributionType == buffType)
+				m_buff.add(buffType, value);
+}
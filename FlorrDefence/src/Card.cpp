@@ -2,13 +2,13 @@
 #include "AssetManager.hpp"
 #include "Tools.hpp"
 
-Card::Card() {
-    m_texRect.setTextureRect({ { 13, 13 }, { 230, 230 } });
-}
+Card::Card() {}
 
 void Card::setCard(const CardInfo& card) {
     m_card = card;
-    m_texRect.setTexture(&AssetManager::getCardTexture(card.type));
+    const TexRegion& region = AssetManager::getCardRegion(card.type);
+    m_texRect.setTexture(region.texture);
+    m_texRect.setTextureRect({ region.rect.position + sf::Vector2i(13, 13), { 230, 230 } });
     updateColor();
 }
 
@@ -109,22 +109,52 @@ void TowerCard::setReload(float reload, bool top) {
     m_top = top;
 }
 
-void TowerCard::draw(sf::RenderTarget& target, sf::RenderStates states) const {
+void TowerCard::drawPart(Part part, sf::RenderTarget& target, sf::RenderStates states) const {
+    states.transform *= getTransform();
+
+    switch (part) {
+    case Part::Background:
+        target.draw(m_backgroundRect, states);
+        break;
+
+    case Part::Reload: {
+        sf::Vertex quad[6];
+        writeReloadQuad(quad, sf::Transform::Identity);
+        target.draw(quad, 6, sf::PrimitiveType::Triangles, states);
+        break;
+    }
+
+    case Part::Image:
+        target.draw(m_texRect, states);
+        break;
+    }
+}
+
+void TowerCard::writeReloadQuad(sf::Vertex* quad, const sf::Transform& transform) const {
     sf::Color color = DARK_COLORS.at(getCard().rarity);
     color.a = (unsigned char)(color.a * m_alpha);
-    m_reloadRect.setFillColor(color);
 
     float outline = getLength() * (77.f / 922.f);
     float inside = getLength() - outline * 2;
-    m_reloadRect.setSize({ inside, inside * (1.f - m_reload) });
-    if (m_top)
-        m_reloadRect.setPosition({ outline, outline });
-    else
-        m_reloadRect.setPosition({ outline, getLength() - outline - m_reloadRect.getSize().y });
+    sf::Vector2f size(inside, inside * (1.f - m_reload));
+    sf::Vector2f position = m_top ? sf::Vector2f(outline, outline) : sf::Vector2f(outline, getLength() - outline - size.y);
+
+    sf::Transform combined = transform * getTransform();
+    sf::Vector2f leftTop = combined.transformPoint(position);
+    sf::Vector2f rightTop = combined.transformPoint(position + sf::Vector2f(size.x, 0.f));
+    sf::Vector2f leftBottom = combined.transformPoint(position + sf::Vector2f(0.f, size.y));
+    sf::Vector2f rightBottom = combined.transformPoint(position + size);
+
+    quad[0] = { leftTop, color };
+    quad[1] = { rightTop, color };
+    quad[2] = { leftBottom, color };
+    quad[3] = { leftBottom, color };
+    quad[4] = { rightTop, color };
+    quad[5] = { rightBottom, color };
+}
 
-    states.transform *= getTransform();
-   
-    target.draw(m_backgroundRect, states);
-    target.draw(m_reloadRect, states);
-    target.draw(m_texRect, states);
+void TowerCard::draw(sf::RenderTarget& target, sf::RenderStates states) const {
+    drawPart(Part::Background, target, states);
+    drawPart(Part::Reload, target, states);
+    drawPart(Part::Image, target, states);
 }
@@ -79,9 +79,10 @@ CardDescription::CardDescription(const BuffGroup& buff)
 	loadData();
 }
 
-void CardDescription::set(const CardInfo& card, sf::Vector2f cardCenter, float cardSize) {
-	if (m_card != card) {
+void CardDescription::set(const CardInfo& card, sf::Vector2f cardCenter, float cardSize, std::optional<TargetMode> targetMode) {
+	if (m_card != card || m_targetMode != targetMode) {
 		m_card = card;
+		m_targetMode = targetMode;
 
 		updateText();
 		updateTextPosition();
@@ -123,10 +124,10 @@ std::string CardDescription::parseAttrib(const std::string& value, const std::st
 
 	// Looking for buff
 	if (value == "reload" || value == "damage") {
-		attrib = m_buff.get(value).apply(attrib);
+		attrib = m_buff.apply(stringToBuffType(value), attrib);
 	}
 	else if (value == "range") {
-		attrib = m_buff.reach.apply(attrib);
+		attrib = m_buff.apply<BuffType::Reach>(attrib);
 	}
 
 	if (type == "int") {
@@ -212,7 +213,7 @@ void CardDescription::updateText() {
 
 			}
 			else if (valueType == "rarity") {
-				std::string rarity = value == "" ? m_card.rarity : parseAttrib(value, "rarity");
+				std::string rarity = value == "" ? m_card.rarity.str() : parseAttrib(value, "rarity");
 				value = capitalized(rarity);
 				valueColor = rarity;
 			}
@@ -234,6 +235,16 @@ void CardDescription::updateText() {
 			);
 		}
 	}
+
+	// Cycled with T while hovering the tower
+	if (m_targetMode) {
+		m_labels.emplace_back(
+			"Target (T)", capitalized(targetModeToString(*m_targetMode)),
+			contentCharSize,
+			m_colorTable.at("cyan"),
+			m_colorTable.at("white")
+		);
+	}
 }
 
 void CardDescription::updateTextPosition() {
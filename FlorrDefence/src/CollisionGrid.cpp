@@ -0,0 +1,51 @@
+#include "CollisionGrid.hpp"
+#include <algorithm>
+#include <cmath>
+
+CollisionGrid::CollisionGrid(sf::FloatRect bounds, sf::Vector2f cellSize)
+    : m_bounds(bounds), m_cellSize(cellSize) {
+    m_cols = std::max(1, (int)std::ceil(bounds.size.x / cellSize.x));
+    m_rows = std::max(1, (int)std::ceil(bounds.size.y / cellSize.y));
+    m_cells.resize(m_cols * m_rows);
+}
+
+void CollisionGrid::clear() {
+    // Keep the cell capacity, the grid is rebuilt every tick
+    for (auto& cell : m_cells)
+        cell.clear();
+}
+
+void CollisionGrid::insert(int id, const sf::FloatRect& box) {
+    sf::IntRect range = getCellRange(box);
+    for (int row = range.position.y; row <= range.position.y + range.size.y; row++)
+        for (int col = range.position.x; col <= range.position.x + range.size.x; col++)
+            m_cells[row * m_cols + col].push_back(id);
+}
+
+void CollisionGrid::query(const sf::FloatRect& box, std::vector<int>& result) const {
+    result.clear();
+
+    sf::IntRect range = getCellRange(box);
+    for (int row = range.position.y; row <= range.position.y + range.size.y; row++)
+        for (int col = range.position.x; col <= range.position.x + range.size.x; col++) {
+            const auto& cell = m_cells[row * m_cols + col];
+            result.insert(result.end(), cell.begin(), cell.end());
+        }
+
+    // An entry spanning several cells shows up once per cell
+    std::sort(result.begin(), result.end());
+    result.erase(std::unique(result.begin(), result.end()), result.end());
+}
+
+sf::IntRect CollisionGrid::getCellRange(const sf::FloatRect& box) const {
+    // Entities outside the map fall into the border cells
+    auto toCol = [&](float x) { return std::clamp((int)std::floor((x - m_bounds.position.x) / m_cellSize.x), 0, m_cols - 1); };
+    auto toRow = [&](float y) { return std::clamp((int)std::floor((y - m_bounds.position.y) / m_cellSize.y), 0, m_rows - 1); };
+
+    int left = toCol(box.position.x);
+    int top = toRow(box.position.y);
+    int right = toCol(box.position.x + box.size.x);
+    int bottom = toRow(box.position.y + box.size.y);
+
+    return sf::IntRect({ left, top }, { right - left, bottom - top });
+}
@@ -5,6 +5,8 @@
 #include <fstream>
 #include <iostream>
 #include <filesystem>
+#include <algorithm>
+#include <format>
 
 const std::vector<std::string> RARITIES = {
 	"common", "unusual", "rare", "epic", "legendary",
@@ -27,6 +29,23 @@ const std::unordered_map<std::string, int> RARITIE_LEVELS = {
 	{"unique", 9}
 };
 
+int getRarityLevel(InternedString rarity) {
+	static const std::vector<int> levels = [] {
+		std::vector<int> result;
+		for (const auto& [name, level] : RARITIE_LEVELS) {
+			uint16_t id = InternedString(name).getId();
+			if (id >= result.size())
+				result.resize(id + 1, 0);
+			result[id] = level;
+		}
+		return result;
+	}();
+
+	if (rarity.getId() >= levels.size() || levels[rarity.getId()] == 0)
+		throw std::out_of_range(std::format("unknown rarity '{}'", rarity.str()));
+	return levels[rarity.getId()];
+}
+
 const std::unordered_map<std::string, std::string> TOWER_SUMMON_MOBS = {
 	{ "ant_egg", "ant_soldier_summoned" },
 	{ "beetle_egg", "beetle_summoned" },
@@ -109,7 +128,7 @@ const std::unordered_map<std::string, sf::Color> DARK_COLORS = {
 InitStates INIT_STATES;
 std::vector<std::string> TOWER_TYPES;
 std::unordered_map<std::string, TowerAttribs> TOWER_ATTRIBS;
-std::unordered_set<std::string> FLOWER_BUFF_TOWERS;
+std::unordered_set<InternedString> FLOWER_BUFF_TOWERS;
 std::unordered_map<std::string, MobAttribs> MOB_ATTRIBS;
 std::unordered_map<std::string, float> MOB_RARITY_FLOWER_DAMGE_MUL;
 std::unordered_map<std::string, ShopAttribs> SHOP_ATTRIBS;
@@ -121,9 +140,14 @@ std::string LOAD_PATH_DEFAULT = "TowerDefence.json";
 std::string SAVE_PATH_DEFAULT = "TowerDefence.json";
 bool AUTO_SAVE_ENABLED = false;
 int AUTO_SAVE_INTERVAL_SECONDS = 60;
+bool SAVE_JOURNAL_ENABLED = true;
 bool SHOW_CONSOLE = false;
 bool DEBUG_MODE = false;
 bool VSYNC_ENABLED = true;
+bool PROFILER_ENABLED = false;
+std::string PROFILER_EXPORT_PATH = "profile.json";
+int SIM_RATE = 60;
+sf::Time SIM_STEP = sf::microseconds(1'000'000 / SIM_RATE);
 
 DamageType stringToDamageType(const std::string& str) {
 	if (str == "normal")
@@ -142,9 +166,16 @@ void loadSettings() {
 			SAVE_PATH_DEFAULT = j.value("save_path_default", SAVE_PATH_DEFAULT);
 			AUTO_SAVE_ENABLED = j.value("auto_save_enabled", AUTO_SAVE_ENABLED);
 			AUTO_SAVE_INTERVAL_SECONDS = j.value("auto_save_interval_seconds", AUTO_SAVE_INTERVAL_SECONDS);
+			SAVE_JOURNAL_ENABLED = j.value("save_journal_enabled", SAVE_JOURNAL_ENABLED);
 			VSYNC_ENABLED = j.value("vsync_enabled", VSYNC_ENABLED);
 			SHOW_CONSOLE = j.value("show_console", SHOW_CONSOLE);
 			DEBUG_MODE = j.value("debug_mode", DEBUG_MODE);
+			PROFILER_ENABLED = j.value("profiler_enabled", PROFILER_ENABLED);
+			PROFILER_EXPORT_PATH = j.value("profiler_export_path", PROFILER_EXPORT_PATH);
+
+			// A step must not be longer than a tick, or ticks would be skipped
+			SIM_RATE = std::clamp(j.value("sim_rate", SIM_RATE), 8, 1000);
+			SIM_STEP = sf::microseconds(1'000'000 / SIM_RATE);
 		}
 		catch (const std::exception& e) {
 			std::cerr << "Failed to parse settings.json: " << e.what() << std::endl;
@@ -195,7 +226,7 @@ static void loadInitSupplies() {
 	INIT_STATES.coin = j["coin"].get<int64_t>();
 	INIT_STATES.talent = j["talent"].get<int>();
 	for (auto& entry : j["cards"])
-		INIT_STATES.cards.emplace_back(CardInfo(entry[0], entry[1]), entry[2].get<int>());
+		INIT_STATES.cards.emplace_back(CardInfo(entry[0].get<std::string>(), entry[1].get<std::string>()), entry[2].get<int>());
 }
 
 static void loadTowerAttribs() {
@@ -230,6 +261,7 @@ static void loadTowerAttribs() {
 			for (auto& [key, val] : entry["attribs"].items()) {
 				e.attribs[key] = val.get<float>();
 			}
+			e.table = AttribTable::compile(e.attribs);
 		}
 
 		// TEST
@@ -268,6 +300,7 @@ void loadMobAttribs() {
 			for (auto& [key, val] : entry["attribs"].items()) {
 				e.attribs[key] = val.get<float>();
 			}
+			e.table = AttribTable::compile(e.attribs);
 		}
 		MOB_ATTRIBS[tyoe] = std::move(ta);
 	}
@@ -327,4 +360,12 @@ void loadConstants() {
 	loadMobAttribs();
 	loadShopAttribs();
 	loadTalentAttribs();
+
+	// Intern rarities and types up front, so their ids are dense and don't depend on play order
+	for (const std::string& rarity : RARITIES)
+		InternedString{ rarity };
+	for (const std::string& type : TOWER_TYPES)
+		InternedString{ type };
+	for (const auto& [type, attribs] : MOB_ATTRIBS)
+		InternedString{ type };
 }
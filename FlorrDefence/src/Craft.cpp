@@ -23,7 +23,7 @@ Craft::Craft(SharedInfo* info)
 void Craft::update() {
 	// Craft
 	if (m_craftState == "crafting") {
-		m_craftInfo.elapsedTime += m_info->dt;
+		m_craftInfo.elapsedTime += m_info->frameDt;
 
 		if (m_craftInfo.elapsedTime >= m_craftInfo.processTime) {
 			endCraft();
@@ -33,7 +33,7 @@ void Craft::update() {
 			float startSpeed = 360.f;
 			float spinSpeed = startSpeed + 3.f * elapsedSec * elapsedSec;
 
-			m_craftTableAngle += sf::degrees(spinSpeed * m_info->dt.asSeconds());
+			m_craftTableAngle += sf::degrees(spinSpeed * m_info->frameDt.asSeconds());
 
 			float frequency = 1.0f + 0.03f * elapsedSec; // slower acceleration
 			float phase = elapsedSec * frequency * 2.f * 3.14159265f + 3.14159265f / 2.f;
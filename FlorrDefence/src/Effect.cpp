@@ -13,6 +13,11 @@ Effect::Effect(const SharedInfo* info)
 	: m_info(info) {}
 
 // Lightning Effect
+ObjectPool& LightningEffect::getPool() {
+	static ObjectPool pool("lightning effect");
+	return pool;
+}
+
 LightningEffect::LightningEffect(const SharedInfo* info, sf::Vector2f root, int rootConnected, std::vector<sf::Vector2f> positions)
 	: Effect(info) {
 	const float delta = 8.f;
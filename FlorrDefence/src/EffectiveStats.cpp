@@ -0,0 +1,30 @@
+#include "EffectiveStats.hpp"
+#include "Map.hpp"
+
+EffectiveStatsCache::Entry& EffectiveStatsCache::getEntry(const CardInfo& card) {
+    auto it = m_entries.find(card);
+    if (it == m_entries.end()) {
+        Entry entry;
+        entry.attribs = &TOWER_ATTRIBS.at(card.type)[card.rarity];
+        it = m_entries.emplace(card, entry).first;
+    }
+    return it->second;
+}
+
+void EffectiveStatsCache::recompute(Entry& entry, const BuffGroup& buff) {
+    const AttribTable& table = entry.attribs->table;
+    auto read = [&](Attrib attrib) { return table.has(attrib) ? table.get(attrib) : 0.f; };
+
+    // Range is in squares in the config
+    const float squareLength = MapInfo::squareSize.x;
+
+    EffectiveStats& stats = entry.stats;
+    stats.reload = buff.apply<BuffType::Reload>(read(Attrib::Reload));
+    stats.range = buff.apply<BuffType::Reach>(read(Attrib::Range) * squareLength);
+    stats.rangeSquared = stats.range * stats.range;
+    stats.damage = buff.apply<BuffType::Damage>(read(Attrib::Damage));
+    stats.speed = buff.apply<BuffType::Speed>(read(Attrib::Speed));
+    stats.copy = read(Attrib::Copy);
+
+    entry.version = buff.getVersion();
+}
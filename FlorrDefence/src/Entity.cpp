@@ -10,11 +10,10 @@ static float angleDelta(float from, float to) {
     return diff;
 }
 
-Entity::Entity(SharedInfo* info, const sf::Texture& texture)
-    : m_info(info), m_sprite(texture)
+Entity::Entity(SharedInfo* info, const TexRegion& region)
+    : m_info(info), m_sprite(region.getTexture(), region.rect)
 {
-    m_sprite.setTexture(texture);
-    m_sprite.setOrigin({ texture.getSize().x / 2.f, texture.getSize().y / 2.f });
+    m_sprite.setOrigin({ region.rect.size.x / 2.f, region.rect.size.y / 2.f });
 }
 
 void Entity::hit(int damage, DamageType type) {
@@ -36,6 +35,12 @@ void Entity::updateAnimation() {
         m_deathTime -= m_info->dt;
 }
 
+void Entity::savePrevious() {
+    m_prevPosition = m_sprite.getPosition();
+    m_prevRotation = m_sprite.getRotation();
+    m_hasPrevious = true;
+}
+
 void Entity::setScale(float scale) {
     m_scale = scale;
     m_sprite.setScale({ scale, scale });
@@ -50,6 +55,11 @@ void Entity::setAlpha(float alpha) {
     m_alpha = alpha;
 }
 
+void Entity::setTexture(const TexRegion& region) {
+    m_sprite.setTexture(region.getTexture());
+    m_sprite.setTextureRect(region.rect);
+}
+
 void Entity::updatePathPosition(float position) {
     static const sf::Vector2f squareSize{ 100.f, 100.f };
     int numSquares = (int)(PATH_SQUARES.size());
@@ -78,6 +88,38 @@ void Entity::updatePathPosition(float position) {
 }
 
 void Entity::draw(sf::RenderTarget& target, sf::RenderStates states) const {
+    SpriteBatch batch;
+    states.shader = getFlashShader();
+    batch.begin(target, states);
+    draw(batch);
+    batch.flush();
+}
+
+void Entity::draw(SpriteBatch& batch) const {
+    std::optional<float> brightness = prepareSprite();
+    if (!brightness)
+        return;
+
+    // Packed brightness is only unpacked by the flash shader
+    if (!getFlashShader())
+        brightness = 0.f;
+    drawInterpolated([&] { batch.add(m_sprite, *brightness); });
+}
+
+const sf::Shader* Entity::getFlashShader() {
+    // Resolved once, nullptr without shader support (entities then draw without the flash)
+    static const sf::Shader* shader = []() -> const sf::Shader* {
+        if (!sf::Shader::isAvailable())
+            return nullptr;
+
+        sf::Shader& flash = AssetManager::getShader("flash");
+        flash.setUniform("brightnessStride", SpriteBatch::brightnessStride);
+        return &flash;
+    }();
+    return shader;
+}
+
+std::optional<float> Entity::prepareSprite() const {
     float alpha = m_alpha;
     if (m_deathTime > sf::Time::Zero) {
         float t = m_deathTime.asSeconds() / getDeathDuration().asSeconds();
@@ -87,27 +129,40 @@ void Entity::draw(sf::RenderTarget& target, sf::RenderStates states) const {
         m_sprite.setScale({ scale, scale });
     }
     else if (isDead()) {
-        return;
+        return std::nullopt;
     }
-    m_sprite.setColor({ 255, 255, 255, (unsigned char)(255 * alpha) });
 
-    if (m_flashTime > sf::Time::Zero) {
-        float strength = std::clamp(m_flashTime.asSeconds() / flashDuration.asSeconds(), 0.f, 1.f);
-        float brightness = m_flashBrightness * strength;
+    if (m_flashTime <= sf::Time::Zero) {
+        m_sprite.setColor({ 255, 255, 255, (unsigned char)(255 * alpha) });
+        return 0.f;
+    }
 
-        sf::Glsl::Vec4 flashColor = sf::Glsl::Vec4(
-            1.f * (1 - strength) + m_flashColor.r / 255.f * strength,
-            1.f * (1 - strength) + m_flashColor.g / 255.f * strength,
-            1.f * (1 - strength) + m_flashColor.b / 255.f * strength,
-            alpha
-        );
+    // The flash tint goes into the vertex color, the brightness into the batch
+    float strength = std::clamp(m_flashTime.asSeconds() / flashDuration.asSeconds(), 0.f, 1.f);
+    auto tint = [&](std::uint8_t channel) {
+        return (unsigned char)(255 * (1.f * (1 - strength) + channel / 255.f * strength));
+    };
 
-        sf::Shader& flashShader = AssetManager::getShader("brightness.frag");
-        flashShader.setUniform("brightness", brightness);
-        flashShader.setUniform("flashColor", flashColor);
+    m_sprite.setColor({ tint(m_flashColor.r), tint(m_flashColor.g), tint(m_flashColor.b), (unsigned char)(255 * alpha) });
+    return m_flashBrightness * strength;
+}
 
-        states.shader = &flashShader;
+template <typename DrawFn>
+void Entity::drawInterpolated(DrawFn drawSprite) const {
+    if (!m_hasPrevious) {
+        drawSprite();
+        return;
     }
 
-    target.draw(m_sprite, states);
+    // Draw between the previous and current step, then restore the simulated state
+    sf::Vector2f position = m_sprite.getPosition();
+    sf::Angle rotation = m_sprite.getRotation();
+    float t = m_info->interpolation;
+
+    m_sprite.setPosition(m_prevPosition + (position - m_prevPosition) * t);
+    m_sprite.setRotation(m_prevRotation + (rotation - m_prevRotation).wrapSigned() * t);
+    drawSprite();
+
+    m_sprite.setPosition(position);
+    m_sprite.setRotation(rotation);
 }
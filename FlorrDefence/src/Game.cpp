@@ -5,6 +5,7 @@
 #include "Constants.hpp"
 #include "OS.hpp"
 #include "Record.hpp"
+#include "Profiler.hpp"
 
 Game::Game(sf::RenderWindow& window)
     : m_window(&window),
@@ -35,19 +36,35 @@ void Game::run() {
     handleEvents();
     update();
     render();
+    Profiler::endFrame();
 
     if (!m_info.playerState.isAlive() && m_gameOver.readyToContinue()) {
         m_request = Request::Restart;
         return;
     }
 
-    m_elapsedTime += m_info.dt.asSeconds();
+    m_elapsedTime += m_info.frameDt.asSeconds();
     m_frameCount++;
 
     if (m_elapsedTime >= 1.f) {
-        if (DEBUG_MODE)
+        if (DEBUG_MODE) {
             std::cout << "FPS: " << m_frameCount << std::endl;
 
+            const CollisionStats& stats = m_map.getCollisionStats();
+            if (stats.ticks > 0)
+                std::cout << "Collision pairs per tick: " << stats.testedPairs / stats.ticks << " tested, "
+                          << stats.collidingPairs / stats.ticks << " colliding, "
+                          << stats.bruteForcePairs / stats.ticks << " without broadphase" << std::endl;
+            m_map.resetCollisionStats();
+
+            // Before batching every entity sprite was its own draw call
+            const BatchStats& batch = m_map.getBatchStats();
+            if (batch.frames > 0)
+                std::cout << "Entity sprites per frame: " << batch.sprites / batch.frames << ", draw calls: "
+                          << batch.drawCalls / batch.frames << std::endl;
+            m_map.resetBatchStats();
+        }
+
         m_frameCount = 0;
         m_elapsedTime = 0.f;
     }
@@ -59,10 +76,13 @@ void Game::run() {
 
             std::cout << "Auto saving..." << std::endl;
 
-            trySaveToPath(std::filesystem::path(SAVE_PATH_DEFAULT));
+            // Only the snapshot is taken on this frame, the write finishes in the background
+            trySaveToPath(std::filesystem::path(SAVE_PATH_DEFAULT), false, true);
             autoSaveClock.restart();
         }
     }
+
+    pollSave();
 }
 
 Game::Request Game::popRequest() {
@@ -72,6 +92,8 @@ Game::Request Game::popRequest() {
 }
 
 void Game::handleEvents() {
+    PROFILE_SCOPE(ProfilePhase::HandleEvents);
+
     while (std::optional event = m_window->pollEvent()) {
         if (event->is<sf::Event::Closed>()) {
             m_window->close();
@@ -168,7 +190,7 @@ void Game::handleFileDialog() {
     }
 }
 
-bool Game::trySaveToPath(const std::filesystem::path& path, bool ignoreThreshold) {
+bool Game::trySaveToPath(const std::filesystem::path& path, bool ignoreThreshold, bool async) {
     try {
         if (path.empty()) {
             std::cerr << "Invalid save path." << std::endl;
@@ -199,12 +221,18 @@ bool Game::trySaveToPath(const std::filesystem::path& path, bool ignoreThreshold
 
         // Perform save
         try {
-            Record::instance().save(*this, path);
+            if (async) {
+                // Reported by pollSave once written
+                if (!Record::instance().saveAsync(*this, path))
+                    return false;
+            }
+            else {
+                Record::instance().save(*this, path);
+                std::cout << "Saved to '" << path.string() << "'" << std::endl;
+            }
 
             m_saveCooldownClock.restart();
             m_hasSavedOnce = true;
-
-            std::cout << "Saved to '" << path.string() << "'" << std::endl;
             return true;
         }
         catch (const std::exception& e) {
@@ -218,6 +246,17 @@ bool Game::trySaveToPath(const std::filesystem::path& path, bool ignoreThreshold
     }
 }
 
+void Game::pollSave() {
+    std::optional<Record::SaveResult> result = Record::instance().pollSave();
+    if (!result)
+        return;
+
+    if (result->success)
+        std::cout << "Saved to '" << result->path.string() << "' in " << result->duration.count() << "ms" << std::endl;
+    else
+        std::cerr << "Save failed: " << result->error << std::endl;
+}
+
 void Game::handleSpecialKey(sf::Keyboard::Key keyCode) {
     if (m_info.playerState.isAlive()) {
 
@@ -240,6 +279,13 @@ void Game::handleSpecialKey(sf::Keyboard::Key keyCode) {
         }
     }
 
+    // F9 -> Export profile
+    if (keyCode == sf::Keyboard::Key::F9 && Profiler::isEnabled()) {
+        Profiler::print();
+        Profiler::exportToFile(PROFILER_EXPORT_PATH);
+        return;
+    }
+
     // Ctrl + O -> Open file
     if (m_info.input.keyCtrl && keyCode == sf::Keyboard::Key::O) {
         if (!OS::open())
@@ -0,0 +1,72 @@
+#include "InternedString.hpp"
+#include <deque>
+#include <unordered_map>
+#include <shared_mutex>
+#include <mutex>
+#include <stdexcept>
+#include <format>
+
+namespace {
+    struct InternTable {
+        InternTable() { intern(""); }  // Id 0 is the empty string
+
+        std::deque<std::string> strings;  // Id -> text, references stay valid as it grows
+        std::unordered_map<std::string, uint16_t> ids;
+        mutable std::shared_mutex mutex;  // Records are serialized off the main thread
+
+        uint16_t intern(const std::string& str) {
+            {
+                std::shared_lock lock(mutex);
+                auto it = ids.find(str);
+                if (it != ids.end())
+                    return it->second;
+            }
+
+            std::unique_lock lock(mutex);
+            auto it = ids.find(str);
+            if (it != ids.end())
+                return it->second;
+
+            if (strings.size() > UINT16_MAX)
+                throw std::runtime_error(std::format("too many interned strings, cannot add '{}'", str));
+
+            uint16_t id = (uint16_t)strings.size();
+            strings.push_back(str);
+            ids.emplace(str, id);
+            return id;
+        }
+
+        const std::string& get(uint16_t id) const {
+            std::shared_lock lock(mutex);
+            return strings[id];
+        }
+
+        size_t size() const {
+            std::shared_lock lock(mutex);
+            return strings.size();
+        }
+    };
+
+    // Constructed on first use, so InternedString constants at namespace scope are safe
+    InternTable& getTable() {
+        static InternTable table;
+        return table;
+    }
+}
+
+InternedString::InternedString()
+    : m_id(0) {}
+
+InternedString::InternedString(const std::string& str)
+    : m_id(getTable().intern(str)) {}
+
+InternedString::InternedString(const char* str)
+    : InternedString(std::string(str)) {}
+
+const std::string& InternedString::str() const {
+    return getTable().get(m_id);
+}
+
+size_t InternedString::getCount() {
+    return getTable().size();
+}
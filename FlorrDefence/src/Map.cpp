@@ -1,8 +1,17 @@
+#include <iostream>
 #include "Map.hpp"
 #include "AssetManager.hpp"
 #include "SpriteCollisionManager.hpp"
+#include "Profiler.hpp"
 
 namespace {
+    // Interned once, so the per step checks compare ids
+    const InternedString SUPER = "super";
+    const InternedString WEB = "web";
+    const InternedString SPIDER = "spider";
+    const InternedString LIGHTNING = "lightning";
+    const InternedString ANT_EGG = "ant_egg";
+
     struct DebugBoxRenderer {
         DebugBoxRenderer() {
             m_shape.setOutlineThickness(2.f);
@@ -85,18 +94,22 @@ void MapInfo::setCard(sf::Vector2i square, const CardInfo& card) {
     tower->setLength(squareSize.x);
     tower->setOrigin(squareSize / 2.f);
     tower->setPosition(getSquareCenter(square));
+    if (dynamic_cast<BuffTower*>(tower.get()))
+        m_info->playerState.buffManager.add(card, square);
     m_map[square.x][square.y] = std::move(tower);
-
-    m_buffUpdated = false;
+    m_placementVersion++;
 }
 
 void MapInfo::removeCard(sf::Vector2i square) {
     if (isEmpty(square))
         return;
 
-    m_map[square.x][square.y].reset();  // Deletes the tower
+    Tower* tower = getTower(square);
+    if (dynamic_cast<BuffTower*>(tower))
+        m_info->playerState.buffManager.remove(tower->getCard(), square);
 
-    m_buffUpdated = false;
+    m_map[square.x][square.y].reset();  // Deletes the tower
+    m_placementVersion++;
 }
 
 int MapInfo::removeAll(const CardInfo& card) {
@@ -152,54 +165,22 @@ void MapInfo::clear() {
     }
 }
 
-void MapInfo::updateTowerBuff() {
+void MapInfo::update() {
     PlayerState& player = m_info->playerState;
-    player.towerBuff.reset();
-
-    int antennaeLevel = (int)player.talentBuff.antennae.apply(0);
-    for (int row = 0; row < MAP_HEIGHT; row++) {
-        for (int col = 0; col < MAP_WIDTH; col++) {
-            if (auto tower = getTower({ row, col }))
-                if (tower->getCard().type == "antennae")
-                    antennaeLevel = std::max(antennaeLevel,
-                        RARITIE_LEVELS.at(tower->getCard().rarity));
-        }
-    }
-
-    BuffManager& buffManager = m_info->playerState.buffManager;
-    buffManager.setAntennaeLevel(antennaeLevel);
-
-    for (int row = 0; row < MAP_HEIGHT; row++) {
-        for (int col = 0; col < MAP_WIDTH; col++) {
-            if (auto tower = getTower({ row, col }))
-                if (auto buffTower = dynamic_cast<BuffTower*>(tower))
-                    buffManager.add(buffTower->getCard(), { row, col });
-        }
-    }
-
-    for (auto square : buffManager.getSquares()) {
-        if (auto tower = getTower(square))
-            if (auto buffTower = dynamic_cast<BuffTower*>(tower))
-                buffTower->applyToBuff();
-    }
-
-    m_buffUpdated = true;
+    player.buffManager.setTalentAntennaeLevel((int)player.talentBuff.apply<BuffType::Antennae>(0));
 
     // Clear card description after buff is changed
-    m_info->cardDescription.clear();
-}
+    if (player.buffManager.getEpoch() != m_buffEpoch) {
+        m_buffEpoch = player.buffManager.getEpoch();
+        m_info->cardDescription.clear();
+    }
 
-void MapInfo::update() {
-    if (!m_buffUpdated)
-        updateTowerBuff();
-    m_info->playerState.applyHealValueBuff(m_info->dt);
+    player.applyHealValueBuff(m_info->dt);
 }
 
 void MapInfo::tick() {
-    // No need to update tower buff because lazy update is sufficient
-    // updateTowerBuff();
-
-    m_info->playerState.buff.mergeFrom(m_info->playerState.towerBuff, m_info->playerState.talentBuff);
+    // The tower buff is kept up to date by the buff manager as towers are placed and removed
+    m_info->playerState.buff.mergeFrom(m_info->playerState.buffManager.getBuff(), m_info->playerState.talentBuff);
 }
 
 bool MapInfo::isValid(sf::Vector2i square) const {
@@ -247,36 +228,93 @@ sf::Vector2f MapInfo::getSquareCenter(sf::Vector2i square) {
 
 // Map
 Map::Map(SharedInfo* info)
-    : m_info(info), m_map(info, this), m_spawner(info) {
+    : m_info(info), m_map(info, this),
+      m_collisionGrid(bounds, MapInfo::squareSize), m_spawner(info) {
     initComponents();
 }
 
 bool Map::update() {
+    // Simulation
+    simulate();
+
+    // Card description
+    updateCardDescription();
+
+    // Boss health bar
+    updateBossHealthBar();
+
+    // Put card request
+    return handlePlaceTowerRequest();
+}
+
+void Map::simulate() {
+    // Run as many whole steps as the frame covers, the remainder is carried
+    // to the next frame and used to interpolate rendering between steps
+    m_stepAccumulator += m_info->frameDt;
+    while (m_stepAccumulator >= SIM_STEP) {
+        step();
+        m_stepAccumulator -= SIM_STEP;
+    }
+
+    m_info->interpolation = m_stepAccumulator / SIM_STEP;
+}
+
+void Map::step() {
+    // Previous state for interpolation
+    for (auto& mob : m_mobs)
+        mob->savePrevious();
+    for (auto& petal : m_petals)
+        petal->savePrevious();
+    for (auto& dead : m_deadMobs)
+        dead->savePrevious();
+    for (auto& dead : m_deadPetals)
+        dead->savePrevious();
+
     // Sub Map
     m_map.update();
 
     // Update Mob Generation
-    m_spawner.update(m_mobs);
+    {
+        PROFILE_SCOPE(ProfilePhase::Spawner);
+        m_spawner.update(m_mobs);
+    }
 
     // Update mobs
-    for (auto& mob : m_mobs)
-        mob->update();
+    {
+        PROFILE_SCOPE(ProfilePhase::MobUpdate);
+        for (auto& mob : m_mobs)
+            mob->update();
+    }
+
+    // Targeting indices, after mobs have moved
+    m_info->pathIndex.update(m_mobs);
+    m_info->mobQuery.update(m_mobs);
 
     // Update towers
-    for (int row = 0; row < MAP_HEIGHT; row++) {
-        for (int col = 0; col < MAP_WIDTH; col++) {
-            if (auto tower = m_map.getTower({ row, col })) {
-                tower->update();
+    {
+        PROFILE_SCOPE(ProfilePhase::TowerUpdate);
+        for (int row = 0; row < MAP_HEIGHT; row++) {
+            for (int col = 0; col < MAP_WIDTH; col++) {
+                if (auto tower = m_map.getTower({ row, col })) {
+                    tower->update();
+                }
             }
         }
     }
 
     // Update petals
-    for (auto& petal : m_petals)
-        petal->update();
+    {
+        PROFILE_SCOPE(ProfilePhase::PetalUpdate);
+        for (auto& petal : m_petals)
+            petal->update();
+    }
 
     // Dead entities
-    for (auto& dead : m_deadEntities) {
+    for (auto& dead : m_deadMobs) {
+        dead->updateAnimation();
+        dead->updatePosition();
+    }
+    for (auto& dead : m_deadPetals) {
         dead->updateAnimation();
         dead->updatePosition();
     }
@@ -285,47 +323,48 @@ bool Map::update() {
     for (auto& effect : m_effects)
         effect->update();
 
-    // Card description
-    if (!m_info->draggedCard.has_value() && isInside(m_info->mouseWorldPosition)) {
-        sf::Vector2i square = m_map.getSquare(m_info->mouseWorldPosition);
-        if (Tower* tower = m_map.getTower(square)) {
-            CardInfo card = tower->getCard();
-            sf::Vector2f pos = MapInfo::getSquareCenter(square);
-            m_info->cardDescription.set(card, pos, MapInfo::squareSize.x);
-        }
-    }
-
     // Tick
     m_tickTimer += m_info->dt;
     if (m_tickTimer >= TICK) {
         tick();
-        m_tickTimer = sf::Time::Zero;
+        m_tickTimer -= TICK;  // Keep the leftover so ticks don't drift
     }
+}
 
-    // Boss health bar update
-    if (m_trackedBoss.has_value() && m_trackedBoss.value()) {
-        Mob* boss = m_trackedBoss.value();
-        if (boss->isDead()) {
-            m_trackedBoss.reset();
-        }
-        else {
-            float hpRatio = (float)boss->getHp() / (float)boss->getAttribs().hp;
-            m_bossHealthBar.update(boss->getMob(), hpRatio);
-        }
+void Map::updateCardDescription() {
+    if (m_info->draggedCard.has_value() || !isInside(m_info->mouseWorldPosition))
+        return;
+
+    sf::Vector2i square = m_map.getSquare(m_info->mouseWorldPosition);
+    if (Tower* tower = m_map.getTower(square)) {
+        CardInfo card = tower->getCard();
+        sf::Vector2f pos = MapInfo::getSquareCenter(square);
+        std::optional<TargetMode> targetMode;
+        if (tower->hasTargetMode())
+            targetMode = tower->getTargetMode();
+        m_info->cardDescription.set(card, pos, MapInfo::squareSize.x, targetMode);
     }
-    if (!m_trackedBoss.has_value()) {
-        for (auto& mob : m_mobs) {
-            if (!mob->isDead() && mob->getMob().rarity == "super") {
-                m_trackedBoss = mob.get();
-                float hpRatio = (float)mob->getHp() / (float)mob->getAttribs().hp;
-                m_bossHealthBar.update(mob->getMob(), hpRatio);
-                break;
-            }
-        }
+}
+
+void Map::updateBossHealthBar() {
+    // The handle goes stale by itself once the boss is removed
+    Mob* boss = m_mobs.get(m_trackedBoss);
+    if (boss && !boss->isDead()) {
+        float hpRatio = (float)boss->getHp() / (float)boss->getAttribs().hp;
+        m_bossHealthBar.update(boss->getMob(), hpRatio);
+        return;
     }
 
-    // Put card request
-    return handlePlaceTowerRequest();
+    m_trackedBoss = {};
+    for (auto it = m_mobs.begin(); it != m_mobs.end(); it++) {
+        const Mob* mob = it->get();
+        if (!mob->isDead() && mob->getMob().rarity == SUPER) {
+            m_trackedBoss = it.getHandle();
+            float hpRatio = (float)mob->getHp() / (float)mob->getAttribs().hp;
+            m_bossHealthBar.update(mob->getMob(), hpRatio);
+            break;
+        }
+    }
 }
 
 void Map::tick() {
@@ -336,14 +375,37 @@ void Map::tick() {
     tickDeadEntities();
 
     // Collision Detection (Petal <=> Mob)
-    for (auto& petal : m_petals) {
+    {
+        PROFILE_SCOPE(ProfilePhase::Collision);
+
+        // Broadphase: mobs are put into a grid by trimmed bounds, ids follow the mob list order
+        m_collisionGrid.clear();
+        m_collisionMobs.clear();
         for (auto& mob : m_mobs) {
             if (mob->isDead()) continue;
-            if (SpriteCollisionManager::isCollide(petal->getSprite(), mob->getSprite())) {
-                collision(*petal.get(), *mob.get());
+            m_collisionGrid.insert((int)m_collisionMobs.size(), SpriteCollisionManager::getTrimmedBounds(mob->getSprite()));
+            m_collisionMobs.push_back(mob.get());
+        }
 
-                // If petal died after hit, stop checking further
-                if (petal->isDead()) break;
+        m_collisionStats.ticks++;
+        m_collisionStats.bruteForcePairs += (int64_t)m_petals.size() * (int64_t)m_collisionMobs.size();
+
+        // Narrowphase: only pairs sharing a cell reach the pixel test
+        for (auto& petal : m_petals) {
+            m_collisionGrid.query(SpriteCollisionManager::getTrimmedBounds(petal->getSprite()), m_collisionCandidates);
+
+            for (int id : m_collisionCandidates) {
+                Mob* mob = m_collisionMobs[id];
+                if (mob->isDead()) continue;  // Killed earlier this tick, e.g. by a lightning chain
+
+                m_collisionStats.testedPairs++;
+                if (SpriteCollisionManager::isCollide(petal->getSprite(), mob->getSprite())) {
+                    m_collisionStats.collidingPairs++;
+                    collision(*petal.get(), *mob);
+
+                    // If petal died after hit, stop checking further
+                    if (petal->isDead()) break;
+                }
             }
         }
     }
@@ -357,56 +419,47 @@ void Map::tick() {
     tickDeadEntities();
 
     // Tower tick
-    for (int row = 0; row < MAP_HEIGHT; row++) {
-        for (int col = 0; col < MAP_WIDTH; col++) {
-            if (auto tower = m_map.getTower({ row, col })) {
-                tower->tick(m_petals, m_mobs);
+    {
+        PROFILE_SCOPE(ProfilePhase::TowerTick);
+        for (int row = 0; row < MAP_HEIGHT; row++) {
+            for (int col = 0; col < MAP_WIDTH; col++) {
+                if (auto tower = m_map.getTower({ row, col })) {
+                    tower->tick(m_petals, m_mobs);
+                }
             }
         }
     }
 }
 
 void Map::tickDeadEntities() {
+    PROFILE_SCOPE(ProfilePhase::DeadEntities);
+
     // Dead Entities
-    m_deadEntities.erase(
-        std::remove_if(m_deadEntities.begin(), m_deadEntities.end(),
-            [&](auto& e) { return e->isDeadAnimationDone(); }),
-        m_deadEntities.end()
-    );
+    m_deadMobs.remove_if([](auto& e) { return e->isDeadAnimationDone(); });
+    m_deadPetals.remove_if([](auto& e) { return e->isDeadAnimationDone(); });
 
     // Petals
-    for (auto it = m_petals.begin(); it != m_petals.end();) {
-        if (it->get()->isDead()) {
-            it->get()->onDead();
-            m_deadEntities.push_back(std::move(*it));
-            it = m_petals.erase(it);
-        }
-        else {
-            ++it;
-        }
-    }
+    m_petals.eraseIf([&](std::unique_ptr<Petal>& petal) {
+        if (!petal->isDead())
+            return false;
 
-    // Mobs
-    for (auto it = m_mobs.begin(); it != m_mobs.end();) {
-        if (it->get()->isDead()) {
-            if (m_trackedBoss.has_value() && m_trackedBoss.value() == it->get()) {
-                m_trackedBoss.reset();
-            }
-            it->get()->onDead();
+        petal->onDead();
+        m_deadPetals.push_back(std::move(petal));
+        return true;
+    });
 
-            for (auto& petal : m_petals) {
-                if (auto shoot = dynamic_cast<ShootPetal*>(petal.get())) {
-                    shoot->lostTarget(it);
-                }
-            }
+    // Mobs
+    // Handles held by petals and the boss bar go stale once the mob is erased
+    m_mobs.eraseIf([&](std::unique_ptr<Mob>& mob) {
+        if (!mob->isDead())
+            return false;
 
-            m_deadEntities.push_back(std::move(*it));
-            it = m_mobs.erase(it);
-        }
-        else {
-            ++it;
-        }
-    }
+        // Take ownership first, onDead may append to m_mobs (e.g. an egg hatching)
+        Mob& dead = *mob;
+        m_deadMobs.push_back(std::move(mob));
+        dead.onDead();
+        return true;
+    });
 
     // Effects
     m_effects.erase(
@@ -420,10 +473,10 @@ void Map::collision(Petal& petal, Mob& mob) {
     if (mob.isUnderground())
         return;
 
-    if (petal.getCard().type == "web" && mob.getMob().type == "spider")
+    if (petal.getCard().type == WEB && mob.getMob().type == SPIDER)
         return;  // Web doesn't effect spiders
 
-    if (petal.getCard().type == "lightning") {
+    if (petal.getCard().type == LIGHTNING) {
         LightningPetal& lightning = dynamic_cast<LightningPetal&>(petal);
         lightning.onHit(mob, m_mobs, m_effects);
     }
@@ -451,6 +504,11 @@ bool Map::onEvent(const sf::Event& event) {
             handleRelease(square);
         }
     }
+    else if (auto key = event.getIf<sf::Event::KeyReleased>()) {
+        if (key->code == sf::Keyboard::Key::T) {
+            handleTargetModeKey(square);
+        }
+    }
 
     return false;
 }
@@ -486,6 +544,15 @@ bool Map::handleRightPress(const sf::Vector2i& square) {
     return false;
 }
 
+void Map::handleTargetModeKey(const sf::Vector2i& square) {
+    Tower* tower = m_map.getTower(square);
+    if (!tower || !tower->hasTargetMode())
+        return;
+
+    // The hovered tower's description shows the new mode on the next update
+    tower->cycleTargetMode();
+}
+
 void Map::handleRelease(const sf::Vector2i& square) {
     if (!m_info->draggedCard.has_value())
         return;
@@ -541,32 +608,66 @@ bool Map::handlePlaceTowerRequest() {
 }
 
 void Map::draw(sf::RenderTarget& target, sf::RenderStates states) const {
-    // Background
-    target.draw(m_background, states);
+    PROFILE_SCOPE(ProfilePhase::MapDraw);
+
+    // Background and towers, only the reload overlays are drawn every frame
+    updateStaticLayers(target, states);
+
+    // Layers hold premultiplied colors after being drawn into with alpha blending
+    sf::RenderStates layerStates = states;
+    layerStates.blendMode = sf::BlendMode(sf::BlendMode::Factor::One, sf::BlendMode::Factor::OneMinusSrcAlpha);
+    layerStates.transform.translate(bounds.position);
+    layerStates.transform.scale(bounds.size.componentWiseDiv(sf::Vector2f(m_staticUnder.getSize())));
 
-    // Towers
+    target.draw(sf::Sprite(m_staticUnder.getTexture()), layerStates);
+
+    // All reload overlays in one draw call
+    size_t reloadVertices = 0;
     for (int row = 0; row < MAP_HEIGHT; row++) {
         for (int col = 0; col < MAP_WIDTH; col++) {
             if (auto tower = m_map.getTower({ row, col })) {
-                target.draw(*tower, states);
+                if (m_reloadBars.getVertexCount() < reloadVertices + 6)
+                    m_reloadBars.resize(reloadVertices + 6);
+                tower->writeReloadQuad(&m_reloadBars[reloadVertices]);
+                reloadVertices += 6;
             }
         }
     }
+    m_reloadBars.resize(reloadVertices);
+    target.draw(m_reloadBars, states);
 
-    // Petals (Web)
-    for (auto& petal : m_petals) {
-        if (dynamic_cast<WebPetal*>(petal.get())) {
-            if (m_info->input.keyG)
-                drawPetalBox(target, states, *petal);
+    target.draw(sf::Sprite(m_staticOver.getTexture()), layerStates);
+
+    // Bucket petals by layer, keeping the list order within a layer
+    for (auto& layer : m_petalLayers)
+        layer.clear();
+    for (auto& petal : m_petals)
+        m_petalLayers[(size_t)petal->getLayer()].push_back(petal.get());
 
-            target.draw(*petal, states);
+    // Entities are batched into vertex arrays, flashing ones included.
+    // Anything drawn straight to the target flushes first.
+    sf::RenderStates entityStates = states;
+    entityStates.shader = Entity::getFlashShader();
+    m_batch.begin(target, entityStates);
+    m_batch.countFrame();
+
+    auto drawPetalLayer = [&](PetalLayer layer) {
+        for (const Petal* petal : m_petalLayers[(size_t)layer]) {
+            if (m_info->input.keyG) {
+                m_batch.flush();
+                drawPetalBox(target, states, *petal);
+            }
+            petal->draw(m_batch);
         }
-    }
+    };
+
+    // Petals (Web)
+    drawPetalLayer(PetalLayer::Ground);
 
     // Mob
     for (auto& mob : m_mobs)
         if (mob->isUnderground())
-            target.draw(*mob, states);
+            mob->draw(m_batch);
 
     m_sortedMobs.clear();
 
@@ -576,52 +677,36 @@ void Map::draw(sf::RenderTarget& target, sf::RenderStates states) const {
 
     std::sort(m_sortedMobs.begin(), m_sortedMobs.end(), [](const Mob* a, const Mob* b) {
         return std::tuple(
-            a->getMob().type != "ant_egg",
-            RARITIE_LEVELS.at(a->getMob().rarity)
+            a->getMob().type != ANT_EGG,
+            getRarityLevel(a->getMob().rarity)
         ) < std::tuple(
-            b->getMob().type != "ant_egg",
-            RARITIE_LEVELS.at(b->getMob().rarity)
+            b->getMob().type != ANT_EGG,
+            getRarityLevel(b->getMob().rarity)
         );
     });
 
     for (Mob* mob : m_sortedMobs) {
-        if (m_info->input.keyH)
+        if (m_info->input.keyH) {
+            m_batch.flush();
             drawMobBox(target, states, *mob);
+        }
 
-        target.draw(*mob, states);
+        mob->draw(m_batch);
     }
 
     // Dead Mobs
-    for (auto& e : m_deadEntities) {
-        if (dynamic_cast<Mob*>(e.get()))
-            target.draw(*e, states);
-    }
+    for (auto& dead : m_deadMobs)
+        dead->draw(m_batch);
 
     // Petals
-    for (auto& petal : m_petals) {
-        if (dynamic_cast<MobPetal*>(petal.get())) {
-            if (m_info->input.keyG) {
-                drawPetalBox(target, states, *petal);
-            }
-            target.draw(*petal, states);
-        }
-    }
-
-    for (auto& petal : m_petals) {
-        if (!dynamic_cast<MobPetal*>(petal.get()) &&
-            !dynamic_cast<WebPetal*>(petal.get())) {
-            if (m_info->input.keyG) {
-                drawPetalBox(target, states, *petal);
-            }
-            target.draw(*petal, states);
-        }
-    }
+    drawPetalLayer(PetalLayer::Summon);
+    drawPetalLayer(PetalLayer::Projectile);
 
     // Dead Petals
-    for (auto& e : m_deadEntities) {
-        if (dynamic_cast<Petal*>(e.get()))
-            target.draw(*e, states);
-    }
+    for (auto& dead : m_deadPetals)
+        dead->draw(m_batch);
+
+    m_batch.flush();
 
     // Tower after-entities effects
     for (int row = 0; row < MAP_HEIGHT; row++) {
@@ -637,7 +722,7 @@ void Map::draw(sf::RenderTarget& target, sf::RenderStates states) const {
         target.draw(*effect, states);
 
     // Boss health bar
-    if (m_trackedBoss.has_value())
+    if (m_mobs.contains(m_trackedBoss))
         target.draw(m_bossHealthBar, states);
 
     // Dragged card
@@ -656,6 +741,53 @@ void Map::draw(sf::RenderTarget& target, sf::RenderStates states) const {
     }
 }
 
+void Map::updateStaticLayers(const sf::RenderTarget& target, const sf::RenderStates& states) const {
+    // One texel per pixel the map covers on the target, so the layers are neither shrunk nor stretched
+    sf::Vector2i topLeft = target.mapCoordsToPixel(states.transform.transformPoint(bounds.position));
+    sf::Vector2i bottomRight = target.mapCoordsToPixel(states.transform.transformPoint(bounds.position + bounds.size));
+    sf::Vector2u size(
+        (unsigned)std::max(std::abs(bottomRight.x - topLeft.x), 1),
+        (unsigned)std::max(std::abs(bottomRight.y - topLeft.y), 1)
+    );
+
+    if (m_staticVersion == m_map.getPlacementVersion() && m_staticUnder.getSize() == size)
+        return;
+
+    // Created on first draw, headless runs never get here. Antialiased like the window,
+    // the card edges would otherwise lose the smoothing they get when drawn to it directly.
+    if (m_staticUnder.getSize() != size) {
+        sf::ContextSettings settings;
+        settings.antiAliasingLevel = ANTI_ALIASING_LEVEL;
+
+        if (!m_staticUnder.resize(size, settings) || !m_staticOver.resize(size, settings))
+            throw std::runtime_error("Failed to create the static map layers");
+
+        m_staticUnder.setSmooth(true);
+        m_staticOver.setSmooth(true);
+    }
+
+    sf::View view(bounds);
+    m_staticUnder.setView(view);
+    m_staticOver.setView(view);
+
+    m_staticUnder.clear(sf::Color::Transparent);
+    m_staticOver.clear(sf::Color::Transparent);
+
+    m_staticUnder.draw(m_background);
+    for (int row = 0; row < MAP_HEIGHT; row++) {
+        for (int col = 0; col < MAP_WIDTH; col++) {
+            if (auto tower = m_map.getTower({ row, col })) {
+                tower->drawCardPart(TowerCard::Part::Background, m_staticUnder, {});
+                tower->drawCardPart(TowerCard::Part::Image, m_staticOver, {});
+            }
+        }
+    }
+
+    m_staticUnder.display();
+    m_staticOver.display();
+    m_staticVersion = m_map.getPlacementVersion();
+}
+
 bool Map::isInside(sf::Vector2f position) const {
     return bounds.contains(position);
 }
@@ -3,25 +3,41 @@
 #include "Tools.hpp"
 #include "Map.hpp"
 
+// Interned once, compared by id on every spawn
+namespace {
+    const InternedString SPIDER = "spider";
+    const InternedString HORNET = "hornet";
+    const InternedString ROACH = "roach";
+    const InternedString FLY = "fly";
+    const InternedString WORM = "worm";
+    const InternedString ANT_QUEEN = "ant_queen";
+    const InternedString ANT_EGG = "ant_egg";
+}
+
 // Mob
-std::unique_ptr<Mob> Mob::create(SharedInfo* info, const MobInfo& mob, std::list<std::unique_ptr<Mob>>& mobs) {
-    if (mob.type == "spider")
+std::unique_ptr<Mob> Mob::create(SharedInfo* info, const MobInfo& mob, MobSlots& mobs) {
+    if (mob.type == SPIDER)
         return std::make_unique<SpiderMob>(info, mob);
-    if (mob.type == "hornet")
+    if (mob.type == HORNET)
         return std::make_unique<HornetMob>(info, mob, mobs);
-    if (mob.type == "roach")
+    if (mob.type == ROACH)
         return std::make_unique<RoachMob>(info, mob);
-    if (mob.type == "fly")
+    if (mob.type == FLY)
         return std::make_unique<FlyMob>(info, mob);
-    if (mob.type == "worm")
+    if (mob.type == WORM)
         return std::make_unique<WormMob>(info, mob);
-    if (mob.type == "ant_queen")
+    if (mob.type == ANT_QUEEN)
         return std::make_unique<AntQueenMob>(info, mob, mobs);
-    if (mob.type == "ant_egg")
+    if (mob.type == ANT_EGG)
         return std::make_unique<AntEggMob>(info, mob, mobs);
     return std::make_unique<Mob>(info, mob);
 }
 
+ObjectPool& Mob::getPool() {
+    static ObjectPool pool("mob");
+    return pool;
+}
+
 const std::unordered_map<std::string, float> Mob::raritySlowDownResistance = {
     {"common", 1.f },
     {"unusual", 0.95f },
@@ -45,7 +61,8 @@ const std::unordered_map<std::string, float> Mob::rarityKnockbackResistance = {
 };
 
 Mob::Mob(SharedInfo* info, const MobInfo& mob, float startPosition)
-    : m_mob(mob), m_position(startPosition), Entity(info, AssetManager::getMobTexture(mob.type)) {
+    : m_mob(mob), m_attribs(&MOB_ATTRIBS.at(mob.type)[mob.rarity]), m_position(startPosition),
+      Entity(info, AssetManager::getMobRegion(mob.type)) {
     setScale(MOB_RARITY_SCALES.at(mob.rarity));
     setFlash(sf::Color(255, 200, 200), 0.9f);
     m_hp = getAttribs().hp;
@@ -102,6 +119,11 @@ void Mob::updatePosition() {
     updatePathPosition(m_position);
 }
 
+void Mob::setPathPosition(float position) {
+    m_position = std::clamp(position, 0.f, 39.f);
+    updatePathPosition(m_position);
+}
+
 int Mob::getArmor() const {
     return (int)m_debuff.armor.apply((float)getAttribs().armor);
 }
@@ -140,14 +162,14 @@ void Mob::onDead() {
 
 // Spider Mob
 void SpiderMob::updatePosition() {
-    rotate(sf::degrees(getAttrib("rotation_speed") * m_info->dt.asSeconds()));
+    rotate(sf::degrees(getAttrib(Attrib::RotationSpeed) * m_info->dt.asSeconds()));
 
     // Movement along path
     Mob::updatePosition();
 }
 
 // Hornet Mob
-HornetMob::HornetMob(SharedInfo* info, const MobInfo& mob, std::list<std::unique_ptr<Mob>>& mobs)
+HornetMob::HornetMob(SharedInfo* info, const MobInfo& mob, MobSlots& mobs)
     : m_mobs(mobs), Mob(info, mob) {
     nextShootInterval();
 }
@@ -168,7 +190,7 @@ void HornetMob::update() {
         float curr = getRotationOffset().asDegrees();
 
         if (curr < 180.f) {
-            float offset = getAttrib("rotation_speed") * m_info->dt.asSeconds();
+            float offset = getAttrib(Attrib::RotationSpeed) * m_info->dt.asSeconds();
             sf::Angle next = sf::degrees(std::min(180.f, curr + offset));
             setRotationOffset(next);
         }
@@ -180,7 +202,7 @@ void HornetMob::update() {
     }
 
     case State::WaitingBeforeShoot: {
-        if (elapsed >= getAttrib("pre_shoot_delay")) {
+        if (elapsed >= getAttrib(Attrib::PreShootDelay)) {
             m_state = State::Shooting;
         }
         break;
@@ -194,7 +216,7 @@ void HornetMob::update() {
     }
 
     case State::WaitingAfterShoot: {
-        if (elapsed >= getAttrib("post_shoot_delay")) {
+        if (elapsed >= getAttrib(Attrib::PostShootDelay)) {
             m_state = State::TurningFront;
         }
         break;
@@ -204,7 +226,7 @@ void HornetMob::update() {
         float curr = getRotationOffset().asDegrees();
 
         if (curr > 0.f) {
-            float offset = getAttrib("rotation_speed") * m_info->dt.asSeconds();
+            float offset = getAttrib(Attrib::RotationSpeed) * m_info->dt.asSeconds();
             sf::Angle next = sf::degrees(std::max(0.f, curr - offset));
             setRotationOffset(next);
         }
@@ -229,8 +251,8 @@ float HornetMob::getSpeed() const {
 };
 
 void HornetMob::nextShootInterval() {
-    float base = getAttrib("shoot_interval");
-    float jitter = getAttrib("shoot_interval_jitter");
+    float base = getAttrib(Attrib::ShootInterval);
+    float jitter = getAttrib(Attrib::ShootIntervalJitter);
     m_currShootInterval = base + randomUniform(-jitter, jitter);
 }
 
@@ -250,9 +272,9 @@ static inline float lerp(float a, float b, float t) {
 
 void RoachMob::update() {
     const float baseSpeed = getAttribs().speed;
-    const float runningSpeed = getAttrib("running_speed");
-    const float speedUpDur = getAttrib("speed_up_duration");
-    const float slowDownDur = getAttrib("slow_down_duration");
+    const float runningSpeed = getAttrib(Attrib::RunningSpeed);
+    const float speedUpDur = getAttrib(Attrib::SpeedUpDuration);
+    const float slowDownDur = getAttrib(Attrib::SlowDownDuration);
 
     m_timer += m_info->dt;
     const float elapsed = m_timer.asSeconds();
@@ -310,12 +332,12 @@ float RoachMob::getSpeed() const {
 }
 
 void RoachMob::nextPeriod() {
-    float restBase = getAttrib("rest_duration");
-    float restJitter = getAttrib("rest_duration_jitter");
+    float restBase = getAttrib(Attrib::RestDuration);
+    float restJitter = getAttrib(Attrib::RestDurationJitter);
     m_currRestTime = restBase + randomUniform(-restJitter, restJitter);
 
-    float runningBase = getAttrib("running_duration");
-    float runningJitter = getAttrib("running_duration_jitter");
+    float runningBase = getAttrib(Attrib::RunningDuration);
+    float runningJitter = getAttrib(Attrib::RunningDurationJitter);
     m_currRunningTime = runningBase + randomUniform(-runningJitter, runningJitter);
 }
 
@@ -323,8 +345,8 @@ void RoachMob::nextPeriod() {
 void FlyMob::updatePosition() {
     const float dt = m_info->dt.asSeconds();
 
-    float rotationSpeed = getAttrib("rotation_speed");
-    float range = getAttrib("rotation_range");
+    float rotationSpeed = getAttrib(Attrib::RotationSpeed);
+    float range = getAttrib(Attrib::RotationRange);
     const float cycle = 4.f * range;
     m_headDeg = fmod(m_headDeg + rotationSpeed * dt, cycle);
 
@@ -335,7 +357,7 @@ void FlyMob::updatePosition() {
 }
 
 void FlyMob::hit(int damage, DamageType type) {
-    if (type == DamageType::Normal && randomUniform(0.f, 1.f) <= getAttrib("evasion"))
+    if (type == DamageType::Normal && randomUniform(0.f, 1.f) <= getAttrib(Attrib::Evasion))
         return;
     Mob::hit(damage, type);
 }
@@ -345,10 +367,10 @@ void WormMob::nextDuration() {
     if (!m_timerStarted) {
         m_timerStarted = true;
         if (m_state == State::AboveGround) {
-            m_currDuration = randomUniform(getAttrib("aboveground_duration_low"), getAttrib("aboveground_duration_high"));
+            m_currDuration = randomUniform(getAttrib(Attrib::AbovegroundDurationLow), getAttrib(Attrib::AbovegroundDurationHigh));
         }
         else {  // State::UnderGround
-            m_currDuration = randomUniform(getAttrib("underground_duration_low"), getAttrib("underground_duration_high"));
+            m_currDuration = randomUniform(getAttrib(Attrib::UndergroundDurationLow), getAttrib(Attrib::UndergroundDurationHigh));
         }
     }
 }
@@ -365,9 +387,9 @@ void WormMob::update() {
     
     // Texture
     if (m_state == State::Underground)
-        m_sprite.setTexture(AssetManager::getMobTexture("worm_underground"));
+        setTexture(AssetManager::getMobRegion("worm_underground"));
     else
-        m_sprite.setTexture(AssetManager::getMobTexture("worm"));
+        setTexture(AssetManager::getMobRegion("worm"));
     
     Mob::update();
 }
@@ -381,7 +403,7 @@ bool WormMob::isUnderground() const {
 }
 
 // Queen Ant
-AntQueenMob::AntQueenMob(SharedInfo* info, const MobInfo& mob, std::list<std::unique_ptr<Mob>>& mobs)
+AntQueenMob::AntQueenMob(SharedInfo* info, const MobInfo& mob, MobSlots& mobs)
     : m_mobs(mobs), Mob(info, mob) {
     nextDuration();
 }
@@ -423,10 +445,10 @@ float AntQueenMob::getSpeed() const {
 
 void AntQueenMob::nextDuration() {
     if (m_state == State::Moving) {
-        m_currDuration = randomUniform(getAttrib("move_duration_low"), getAttrib("move_duration_high"));
+        m_currDuration = randomUniform(getAttrib(Attrib::MoveDurationLow), getAttrib(Attrib::MoveDurationHigh));
     }
     else {  // State::Spawning
-        m_currDuration = randomUniform(getAttrib("spawn_duration_low"), getAttrib("spawn_duration_high"));
+        m_currDuration = randomUniform(getAttrib(Attrib::SpawnDurationLow), getAttrib(Attrib::SpawnDurationHigh));
     }
 }
 
@@ -435,14 +457,14 @@ void AntQueenMob::spawn() {
 }
 
 // Ant Egg
-AntEggMob::AntEggMob(SharedInfo* info, const MobInfo& mob, std::list<std::unique_ptr<Mob>>& mobs, float startPosition)
+AntEggMob::AntEggMob(SharedInfo* info, const MobInfo& mob, MobSlots& mobs, float startPosition)
     : m_mobs(mobs), Mob(info, mob, startPosition) {
     setScale(m_scale * 0.5f);
 }
 
 void AntEggMob::update() {
     m_timer += m_info->dt;
-    if (m_timer.asSeconds() > getAttrib("max_dutation")) {
+    if (m_timer.asSeconds() > getAttrib(Attrib::MaxDuration)) {
         kill();
         return;
     }
@@ -451,7 +473,7 @@ void AntEggMob::update() {
 }
 
 void AntEggMob::onDead() {
-    float spawnChance = getAttrib("spawn_chance");
+    float spawnChance = getAttrib(Attrib::SpawnChance);
     if (randomUniform(0.f, 1.f) <= spawnChance)
         m_mobs.push_back(std::make_unique<Mob>(m_info, MobInfo{ m_mob.rarity, "ant_baby" }, m_position));
 }
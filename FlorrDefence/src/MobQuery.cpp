@@ -0,0 +1,74 @@
+#include "MobQuery.hpp"
+#include <algorithm>
+#include "Mob.hpp"
+#include "Constants.hpp"
+#include "Tools.hpp"
+
+MobQuery::MobQuery()
+    : m_grid(sf::FloatRect({ 0.f, 0.f }, { MAP_WIDTH * cellSize, MAP_HEIGHT * cellSize }), { cellSize, cellSize }) {}
+
+void MobQuery::update(const MobSlots& mobs) {
+    m_mobs = &mobs;
+    m_entries.clear();
+    m_grid.clear();
+
+    for (auto it = mobs.begin(); it != mobs.end(); it++) {
+        m_grid.insert((int)m_entries.size(), sf::FloatRect(it->get()->getPosition(), { 0.f, 0.f }));
+        m_entries.push_back({ it.getHandle(), it->get() });
+    }
+}
+
+std::optional<MobHandle> MobQuery::nearest(sf::Vector2f center, float radius) const {
+    collect(center, radius, false);
+    if (m_found.empty())
+        return std::nullopt;
+
+    // Ties go to the mob earlier in the list
+    auto best = std::min_element(m_found.begin(), m_found.end());
+    return m_entries[best->second].handle;
+}
+
+void MobQuery::kNearest(sf::Vector2f center, float radius, int k, std::vector<MobHandle>& result) const {
+    result.clear();
+    if (k <= 0)
+        return;
+
+    collect(center, radius, false);
+    auto end = m_found.begin() + std::min((size_t)k, m_found.size());
+    std::partial_sort(m_found.begin(), end, m_found.end());
+
+    for (auto it = m_found.begin(); it != end; it++)
+        result.push_back(m_entries[it->second].handle);
+}
+
+void MobQuery::withinRadius(sf::Vector2f center, float radius, std::vector<MobHandle>& result,
+                            bool includeUnderground) const {
+    result.clear();
+
+    collect(center, radius, includeUnderground);
+    for (const auto& [distSquared, entry] : m_found)
+        result.push_back(m_entries[entry].handle);
+}
+
+void MobQuery::collect(sf::Vector2f center, float radius, bool includeUnderground) const {
+    m_found.clear();
+    if (!m_mobs)
+        return;
+
+    // Candidates come back sorted, so results stay in mob list order
+    sf::FloatRect box(center - sf::Vector2f(radius, radius), { radius * 2.f, radius * 2.f });
+    m_grid.query(box, m_candidates);
+
+    const float radiusSquared = radius * radius;
+    for (int id : m_candidates) {
+        const Entry& entry = m_entries[id];
+
+        // Skip mobs removed since the last update
+        if (!m_mobs->contains(entry.handle)) continue;
+        if (!includeUnderground && entry.mob->isUnderground()) continue;
+
+        float distSquared = getDistanceSquare(center, entry.mob->getPosition());
+        if (distSquared <= radiusSquared)
+            m_found.emplace_back(distSquared, id);
+    }
+}
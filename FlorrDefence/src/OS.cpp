@@ -4,7 +4,10 @@
 
 #ifdef _WIN32
 #include <windows.h>
+#include <psapi.h>
 #include <cstdio>
+#else
+#include <sys/resource.h>
 #endif
 
 std::unique_ptr<pfd::open_file> OS::m_openDialog;
@@ -19,7 +22,7 @@ bool OS::open() {
         "Open",
         "",
         std::vector<std::string>{
-            "JSON Files", "*.json",
+            "Records", "*.json *.fdr",
             "All Files", "*"
         }
     );
@@ -36,7 +39,8 @@ bool OS::saveAs() {
         "Save As",
         "FlorrDefence.json",
         std::vector<std::string>{
-            "JSON Files", "*.json",
+            "JSON Records", "*.json",
+            "Binary Records", "*.fdr",
             "All Files", "*"
         }
     );
@@ -139,3 +143,21 @@ void OS::showConsole(bool show) {
     (void)show;
 #endif
 }
+
+size_t OS::getPeakMemory() {
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS counters;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+        return counters.PeakWorkingSetSize;
+    return 0;
+#else
+    rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0)
+        return 0;
+#ifdef __APPLE__
+    return (size_t)usage.ru_maxrss;  // Bytes on macOS
+#else
+    return (size_t)usage.ru_maxrss * 1024;  // Kilobytes elsewhere
+#endif
+#endif
+}
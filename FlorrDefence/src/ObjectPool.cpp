@@ -0,0 +1,47 @@
+#include "ObjectPool.hpp"
+#include <algorithm>
+
+ObjectPool::ObjectPool(std::string name, size_t blocksPerChunk)
+    : m_name(std::move(name)), m_blocksPerChunk(blocksPerChunk) {}
+
+void* ObjectPool::allocate(size_t size) {
+    size_t sizeClass = (size + alignment - 1) / alignment;
+    if (sizeClass >= m_freeLists.size())
+        m_freeLists.resize(sizeClass + 1);
+
+    if (m_freeLists[sizeClass].empty())
+        addChunk(sizeClass);
+
+    void* ptr = m_freeLists[sizeClass].back();
+    m_freeLists[sizeClass].pop_back();
+
+    m_stats.allocations++;
+    m_stats.inUse++;
+    m_stats.highWater = std::max(m_stats.highWater, m_stats.inUse);
+
+    return ptr;
+}
+
+void ObjectPool::deallocate(void* ptr, size_t size) {
+    if (!ptr)
+        return;
+
+    size_t sizeClass = (size + alignment - 1) / alignment;
+    m_freeLists[sizeClass].push_back(ptr);
+    m_stats.inUse--;
+}
+
+void ObjectPool::addChunk(size_t sizeClass) {
+    // new[] of std::byte is aligned for any fundamental type, blocks keep that alignment
+    const size_t blockSize = sizeClass * alignment;
+    auto chunk = std::make_unique<std::byte[]>(blockSize * m_blocksPerChunk);
+
+    // Push in reverse so blocks are handed out in address order
+    auto& freeList = m_freeLists[sizeClass];
+    for (size_t i = m_blocksPerChunk; i-- > 0;)
+        freeList.push_back(chunk.get() + i * blockSize);
+
+    m_chunks.push_back(std::move(chunk));
+    m_stats.capacity += m_blocksPerChunk;
+    m_stats.heapAllocations++;
+}
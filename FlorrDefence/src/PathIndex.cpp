@@ -0,0 +1,162 @@
+#include "PathIndex.hpp"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <format>
+#include "Mob.hpp"
+#include "Constants.hpp"
+#include "Tools.hpp"
+
+TargetMode stringToTargetMode(const std::string& str) {
+    if (str == "nearest")
+        return TargetMode::Nearest;
+    else if (str == "first")
+        return TargetMode::First;
+    else if (str == "last")
+        return TargetMode::Last;
+    else if (str == "strongest")
+        return TargetMode::Strongest;
+    throw std::runtime_error(std::format("invalid target mode '{}'", str));
+}
+
+std::string targetModeToString(TargetMode mode) {
+    switch (mode) {
+    case TargetMode::First: return "first";
+    case TargetMode::Last: return "last";
+    case TargetMode::Strongest: return "strongest";
+    default: return "nearest";
+    }
+}
+
+// PathIndex
+void PathIndex::update(const MobSlots& mobs) {
+    m_mobs = &mobs;
+    m_entries.clear();
+
+    for (auto it = mobs.begin(); it != mobs.end(); it++)
+        m_entries.push_back({ it->get()->getPathPosition(), it.getHandle(), it->get() });
+
+    // Stable, so mobs at the same position keep the mob list order
+    std::stable_sort(m_entries.begin(), m_entries.end(), [](const Entry& a, const Entry& b) {
+        return a.position > b.position;
+    });
+}
+
+void PathIndex::query(const std::vector<PathInterval>& intervals, sf::Vector2f center, float range,
+                      TargetMode mode, int count, std::vector<MobHandle>& result) const {
+    result.clear();
+    m_scored.clear();
+    if (!m_mobs || count <= 0)
+        return;
+
+    const float rangeSquared = range * range;
+
+    for (const PathInterval& interval : intervals) {
+        // Entries are sorted by descending position
+        auto first = std::lower_bound(m_entries.begin(), m_entries.end(), interval.end,
+            [](const Entry& e, float pos) { return e.position > pos; });
+        auto last = std::upper_bound(first, m_entries.end(), interval.begin,
+            [](float pos, const Entry& e) { return pos > e.position; });
+
+        for (auto it = first; it != last; it++) {
+            // Skip mobs removed since the last update
+            if (!m_mobs->contains(it->handle)) continue;
+
+            const Mob* mob = it->mob;
+            if (mob->isUnderground()) continue;  // Cannot target mobs underground
+
+            float distSquared = getDistanceSquare(center, mob->getPosition());
+            if (distSquared > rangeSquared) continue;
+
+            // Lower score is better
+            float score = 0.f;
+            switch (mode) {
+            case TargetMode::Nearest: score = distSquared; break;
+            case TargetMode::First: score = -mob->getPathPosition(); break;
+            case TargetMode::Last: score = mob->getPathPosition(); break;
+            case TargetMode::Strongest: score = -(float)mob->getHp(); break;
+            }
+
+            m_scored.emplace_back(score, it->handle);
+        }
+    }
+
+    // Intervals don't overlap, so no mob is scored twice
+    auto byScore = [](const auto& a, const auto& b) { return a.first < b.first; };
+    size_t n = std::min(m_scored.size(), (size_t)count);
+    std::partial_sort(m_scored.begin(), m_scored.begin() + n, m_scored.end(), byScore);
+
+    for (size_t i = 0; i < n; i++)
+        result.push_back(m_scored[i].second);
+}
+
+static const float squareLength = 100.f;
+
+// Center of the i-th path square, entering from (5, -1) and leaving to (2, 10)
+static sf::Vector2f getPathSquareCenter(int i) {
+    int numSquares = (int)(PATH_SQUARES.size());
+    sf::Vector2i square = i < 0 ? sf::Vector2i(5, -1) : i < numSquares ? PATH_SQUARES[i] : sf::Vector2i(2, 10);
+    return {
+        square.y * squareLength + squareLength / 2.f,
+        square.x * squareLength + squareLength / 2.f
+    };
+}
+
+sf::Vector2f PathIndex::getPathPoint(float position) {
+    // Same walk as Entity::updatePathPosition
+    int i = (int)(std::floor(position - 0.5f - 1e-3f));
+    sf::Vector2f p0 = getPathSquareCenter(i);
+    sf::Vector2f p1 = getPathSquareCenter(i + 1);
+
+    float t = position - i - 0.5f;
+    return p0 + (p1 - p0) * t;
+}
+
+std::vector<PathInterval> PathIndex::computeIntervals(sf::Vector2f center, float range) {
+    std::vector<PathInterval> intervals;
+    const float epsilon = 1e-3f;  // Keep mobs exactly on the range border
+
+    // Segment k covers positions [k + 0.5, k + 1.5]
+    for (int k = -1; k + 0.5f < maxPosition; k++) {
+        float segBegin = k + 0.5f;
+        sf::Vector2f a = getPathSquareCenter(k);
+        sf::Vector2f b = getPathSquareCenter(k + 1);
+        sf::Vector2f d = b - a;
+        sf::Vector2f f = a - center;
+
+        // |a + d t - center|^2 <= range^2
+        float qa = d.x * d.x + d.y * d.y;
+        float qb = 2.f * (d.x * f.x + d.y * f.y);
+        float qc = f.x * f.x + f.y * f.y - range * range;
+        float disc = qb * qb - 4.f * qa * qc;
+        if (qa <= 0.f || disc < 0.f)
+            continue;
+
+        float root = std::sqrt(disc);
+        float t0 = std::max(0.f, (-qb - root) / (2.f * qa));
+        float t1 = std::min(1.f, (-qb + root) / (2.f * qa));
+        if (t0 > t1)
+            continue;
+
+        float begin = std::max(minPosition, segBegin + t0 - epsilon);
+        float end = std::min(maxPosition, segBegin + t1 + epsilon);
+        if (begin > end)
+            continue;
+
+        if (!intervals.empty() && intervals.back().end >= begin)
+            intervals.back().end = std::max(intervals.back().end, end);
+        else
+            intervals.push_back({ begin, end });
+    }
+
+    return intervals;
+}
+
+// PathCoverage
+const std::vector<PathInterval>& PathCoverage::get(sf::Vector2f center, float range) {
+    if (range != m_range) {
+        m_intervals = PathIndex::computeIntervals(center, range);
+        m_range = range;
+    }
+    return m_intervals;
+}
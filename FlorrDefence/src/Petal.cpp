@@ -3,10 +3,21 @@
 #include "Tools.hpp"
 #include "AssetManager.hpp"
 
+// Interned once, compared by id on every shot
+namespace {
+	const InternedString LIGHTNING = "lightning";
+	const InternedString PINCER = "pincer";
+	const InternedString DICE = "dice";
+	const InternedString BUR = "bur";
+	const InternedString CHIP = "chip";
+	const InternedString WEB = "web";
+	const InternedString JELLY = "jelly";
+}
+
 // Petal
 Petal::Petal(SharedInfo* info, const CardInfo& card)
-	: m_attribs(TOWER_ATTRIBS[card.type][card.rarity]), m_card(card),
-	Entity(info, AssetManager::getPetalTexture(card.type)) {
+	: m_attribs(TOWER_ATTRIBS[card.type][card.rarity]), m_stats(&info->effectiveStats.getEntry(card)), m_card(card),
+	Entity(info, AssetManager::getPetalRegion(card.type)) {
 	setScale(0.32f);
 	setFlash(sf::Color(180, 0, 0), 0.4f);
 	m_hp = getFullHp();
@@ -14,29 +25,34 @@ Petal::Petal(SharedInfo* info, const CardInfo& card)
 	m_info->counter.petal[card]++;
 }
 
-Petal::Petal(SharedInfo* info, const CardInfo& card, const sf::Texture& texture)
-	: m_attribs(TOWER_ATTRIBS[card.type][card.rarity]), m_card(card),
-	Entity(info, texture) {
+Petal::Petal(SharedInfo* info, const CardInfo& card, const TexRegion& region)
+	: m_attribs(TOWER_ATTRIBS[card.type][card.rarity]), m_stats(&info->effectiveStats.getEntry(card)), m_card(card),
+	Entity(info, region) {
 	setFlash(sf::Color(180, 0, 0), 0.4f);
 
 	m_info->counter.petal[card]++;
 }
 
+ObjectPool& Petal::getPool() {
+	static ObjectPool pool("petal");
+	return pool;
+}
+
 int Petal::getFullHp() const {
-	return (int)round(getAttrib("hp"));
+	return (int)round(getAttrib(Attrib::Hp));
 }
 
 int Petal::getArmor() const {
-	return hasAttrib("armor") ? int(getAttrib("armor")) : 0;
+	return hasAttrib(Attrib::Armor) ? int(getAttrib(Attrib::Armor)) : 0;
 }
 
 int Petal::getDamage() const {
-	return int(round(getBuffedAttrib("damage")));
+	return int(round(getStats().damage));
 }
 
 void Petal::onDead() {
-	if (hasAttrib("death_heal"))
-		m_info->playerState.heal(getAttrib("death_heal"));
+	if (hasAttrib(Attrib::DeathHeal))
+		m_info->playerState.heal(getAttrib(Attrib::DeathHeal));
 
 	m_info->counter.petal[getCard()]--;
 }
@@ -47,18 +63,18 @@ void Petal::heal(float percent) {
 }
 
 // ShootPetal
-std::unique_ptr<ShootPetal> ShootPetal::create(SharedInfo* info, const CardInfo& card, sf::Vector2f startPosition, std::list<std::unique_ptr<Mob>>::const_iterator target) {
-	if (card.type == "lightning")
-		return std::make_unique<LightningPetal>(info, card, startPosition, target);
-	else if (card.type == "pincer")
-		return std::make_unique<PincerPetal>(info, card, startPosition, target);
-	else if (card.type == "dice")
-		return std::make_unique<DicePetal>(info, card, startPosition, target);
-	else if (card.type == "bur")
-		return std::make_unique<BurPetal>(info, card, startPosition, target);
-	else if (card.type == "chip")
-		return std::make_unique<ChipPetal>(info, card, startPosition, target);
-	return std::make_unique<ShootPetal>(info, card, startPosition, target);
+std::unique_ptr<ShootPetal> ShootPetal::create(SharedInfo* info, const CardInfo& card, sf::Vector2f startPosition, const MobSlots& mobs, MobHandle target) {
+	if (card.type == LIGHTNING)
+		return std::make_unique<LightningPetal>(info, card, startPosition, mobs, target);
+	else if (card.type == PINCER)
+		return std::make_unique<PincerPetal>(info, card, startPosition, mobs, target);
+	else if (card.type == DICE)
+		return std::make_unique<DicePetal>(info, card, startPosition, mobs, target);
+	else if (card.type == BUR)
+		return std::make_unique<BurPetal>(info, card, startPosition, mobs, target);
+	else if (card.type == CHIP)
+		return std::make_unique<ChipPetal>(info, card, startPosition, mobs, target);
+	return std::make_unique<ShootPetal>(info, card, startPosition, mobs, target);
 }
 
 const std::unordered_map<std::string, sf::Angle> ShootPetal::petalTilt = {
@@ -79,12 +95,12 @@ const std::unordered_map<std::string, sf::Angle> ShootPetal::petalTilt = {
 	{"rice", sf::degrees(40.f)}
 };
 
-ShootPetal::ShootPetal(SharedInfo* info, const CardInfo& card, sf::Vector2f startPosition, std::list<std::unique_ptr<Mob>>::const_iterator target)
-	: Petal(info, card), m_startPosition(startPosition), m_target(target) {
+ShootPetal::ShootPetal(SharedInfo* info, const CardInfo& card, sf::Vector2f startPosition, const MobSlots& mobs, MobHandle target)
+	: Petal(info, card), m_startPosition(startPosition), m_mobs(&mobs), m_target(target) {
 	m_sprite.setPosition(startPosition);
 
 	// Face target
-	sf::Vector2f mobPos = m_target.value()->get()->getPosition();
+	sf::Vector2f mobPos = getTarget()->getPosition();
 	sf::Vector2f delta = mobPos - getPosition();
 	if (delta.x != 0.f || delta.y != 0.f) {
 		float angleRad = std::atan2(delta.y, delta.x);
@@ -93,8 +109,8 @@ ShootPetal::ShootPetal(SharedInfo* info, const CardInfo& card, sf::Vector2f star
 	}
 }
 
-ShootPetal::ShootPetal(SharedInfo* info, const CardInfo& card)
-	: Petal(info, card) {}
+ShootPetal::ShootPetal(SharedInfo* info, const CardInfo& card, const MobSlots& mobs)
+	: Petal(info, card), m_mobs(&mobs) {}
 
 void ShootPetal::update() {
 	// Animation
@@ -104,7 +120,7 @@ void ShootPetal::update() {
 	updatePosition();
 
 	// Check if the target became underground
-	if (m_target.has_value() && m_target.value()->get()->isUnderground())
+	if (const Mob* target = getTarget(); target && target->isUnderground())
 		lostTarget();
 
 	// Check if out of bounds
@@ -116,8 +132,7 @@ void ShootPetal::update() {
 
 	sf::Vector2f delta = newPosition - m_startPosition;
 	float dstSquare = delta.x * delta.x + delta.y * delta.y;
-	float range = m_info->playerState.buff.reach.apply(getAttrib("range") * MapInfo::squareSize.x);
-	if (dstSquare > range * range) {
+	if (dstSquare > getStats().rangeSquared) {
 		kill();
 		return;
 	}
@@ -128,7 +143,7 @@ void ShootPetal::updatePosition() {
 	updateDirection(720.f);
 
 	// Move
-	float speed = getBuffedAttrib("speed") * MapInfo::squareSize.x;
+	float speed = getStats().speed * MapInfo::squareSize.x;
 	sf::Vector2f offset(
 		std::cos(m_direction.asRadians()),
 		std::sin(m_direction.asRadians())
@@ -137,12 +152,7 @@ void ShootPetal::updatePosition() {
 }
 
 void ShootPetal::lostTarget() {
-	m_target.reset();
-}
-
-void ShootPetal::lostTarget(std::list<std::unique_ptr<Mob>>::const_iterator target) {
-	if (m_target == target)
-		lostTarget();
+	m_target = {};
 }
 
 void ShootPetal::onDead() {
@@ -152,10 +162,11 @@ void ShootPetal::onDead() {
 }
 
 void ShootPetal::updateDirection(float trunSpeed) {
-	if (!m_target.has_value())
+	const Mob* target = getTarget();
+	if (!target)
 		return;
 
-	sf::Vector2f mobPos = m_target.value()->get()->getPosition();
+	sf::Vector2f mobPos = target->getPosition();
 	sf::Vector2f delta = mobPos - getPosition();
 
 	if (std::abs(delta.x) <= 3.f && std::abs(delta.y) <= 3.f)
@@ -181,9 +192,9 @@ void ShootPetal::updateDirection(float trunSpeed) {
 
 // DefencePetal
 std::unique_ptr<DefencePetal> DefencePetal::create(SharedInfo* info, const CardInfo& card, sf::Vector2i square) {
-	if (card.type == "web")
+	if (card.type == WEB)
 		return std::make_unique<WebPetal>(info, card, square);
-	else if (card.type == "jelly")
+	else if (card.type == JELLY)
 		return std::make_unique<JellyPetal>(info, card, square);
 	return std::make_unique<DefencePetal>(info, card, square);
 }
@@ -219,16 +230,18 @@ std::unique_ptr<MobPetal> MobPetal::create(SharedInfo* info, const CardInfo& car
 }
 
 MobPetal::MobPetal(SharedInfo* info, const CardInfo& card, float startPosition)
-	: Petal(info, card, AssetManager::getPetalTexture(TOWER_SUMMON_MOBS.at(card.type))),
-	m_mob({ RARITIES[(int)TOWER_ATTRIBS[card.type].rarities[card.rarity].attribs["mob_rarity"]], TOWER_SUMMON_MOBS.at(card.type) }),
+	: Petal(info, card, AssetManager::getPetalRegion(TOWER_SUMMON_MOBS.at(card.type))),
+	m_mob({ RARITIES[(int)TOWER_ATTRIBS[card.type].rarities[card.rarity].table.get(Attrib::MobRarity)], TOWER_SUMMON_MOBS.at(card.type) }),
+	m_mobAttribs(&MOB_ATTRIBS.at(m_mob.type)[m_mob.rarity]),
 	m_position(startPosition),
 	m_speedMultiplier(randomUniform(0.9f, 1.1f)) {
+	m_layer = PetalLayer::Summon;
 	float scale = MOB_RARITY_SCALES.at(m_mob.rarity) * 1.5f;
 	setScale(scale);
 
 	m_hp = getFullHp();
 
-	if (hasAttrib("rotation_speed"))
+	if (hasAttrib(Attrib::RotationSpeed))
 		// Random initial direction
 		setRotationOffset(sf::degrees(randomUniform(0.f, 360.f)));
 
@@ -249,8 +262,8 @@ void MobPetal::update() {
 
 void MobPetal::updatePosition() {
 	// Movement along path
-	float speed = m_info->playerState.buff.speed.apply(getMobAttribs().speed) * m_speedMultiplier;
-	bool reverse = m_info->playerState.buff.yin_yang.apply(0) >= RARITIE_LEVELS.at(m_mob.rarity);
+	float speed = m_info->playerState.buff.apply<BuffType::Speed>(getMobAttribs().speed) * m_speedMultiplier;
+	bool reverse = m_info->playerState.buff.apply<BuffType::YinYang>(0) >= getRarityLevel(m_mob.rarity);
 	m_position += (reverse ? 1 : -1) * m_info->dt.asSeconds() * speed;
 	m_position = std::clamp(m_position, 0.f, 39.f);
 
@@ -259,16 +272,16 @@ void MobPetal::updatePosition() {
 		m_sprite.rotate(sf::degrees(180.f));
 
 	// Rotate
-	if (hasAttrib("rotation_speed"))
-		rotate(sf::degrees(getAttrib("rotation_speed") * m_info->dt.asSeconds()));
+	if (hasAttrib(Attrib::RotationSpeed))
+		rotate(sf::degrees(getAttrib(Attrib::RotationSpeed) * m_info->dt.asSeconds()));
 }
 
 int MobPetal::getFullHp() const {
-	return (int)round(m_info->playerState.buff.summoner.apply((float)getMobAttribs().hp));
+	return (int)round(m_info->playerState.buff.apply<BuffType::Summoner>((float)getMobAttribs().hp));
 }
 
 int MobPetal::getDamage() const {
-	return (int)round(m_info->playerState.buff.damage.apply((float)getMobAttribs().damage));
+	return (int)round(m_info->playerState.buff.apply<BuffType::Damage>((float)getMobAttribs().damage));
 }
 
 int MobPetal::getArmor() const {
@@ -278,7 +291,8 @@ int MobPetal::getArmor() const {
 // Web (Defence)
 WebPetal::WebPetal(SharedInfo* info, const CardInfo& card, sf::Vector2i square)
 	: DefencePetal(info, card, square) {
-	setScale(0.32f * getAttrib("scale"));
+	m_layer = PetalLayer::Ground;
+	setScale(0.32f * getAttrib(Attrib::Scale));
 	setAlpha(0.9f);
 }
 
@@ -302,42 +316,40 @@ int WebPetal::getDamage() const {
 }
 
 void WebPetal::applyDebuff(Debuff& debuff) const {
-	const std::string& rarity = getCard().rarity;
-	debuff.webSpeed.swap({ getAttrib("slow_down"), rarity, sf::seconds(0.2f) });
+	InternedString rarity = getCard().rarity;
+	debuff.webSpeed.swap({ getAttrib(Attrib::SlowDown), rarity, sf::seconds(0.2f) });
 }
 
 float WebPetal::getDelta() const {
 	float elapsed = m_timer.asSeconds();
-	float delta = std::max(0.f, 1.f - elapsed / getAttrib("duration"));
+	float delta = std::max(0.f, 1.f - elapsed / getAttrib(Attrib::Duration));
 	return delta;
 }
 
 // Triangle (Shoot)
-TrianglePetal::TrianglePetal(SharedInfo* info, const CardInfo& card, sf::Vector2f startPosition, std::list<std::unique_ptr<Mob>>::const_iterator target, int adjCount)
-	: ShootPetal(info, card, startPosition, target), m_adjCount(adjCount) {}
+TrianglePetal::TrianglePetal(SharedInfo* info, const CardInfo& card, sf::Vector2f startPosition, const MobSlots& mobs, MobHandle target, int adjCount)
+	: ShootPetal(info, card, startPosition, mobs, target), m_adjCount(adjCount) {}
 
 int TrianglePetal::getDamage() const {
-	return Petal::getDamage() + (int)getAttrib("damage_increase") * m_adjCount;
+	return Petal::getDamage() + (int)getAttrib(Attrib::DamageIncrease) * m_adjCount;
 }
 
 // Lightning (Shoot)
-void LightningPetal::onHit(Mob& mob, std::list<std::unique_ptr<Mob>>& mobs, std::list<std::unique_ptr<Effect>>& effects) {
-	using MobsIt = std::list<std::unique_ptr<Mob>>::iterator;
-
-	std::vector<MobsIt> targets = getTargets(mobs);
-	for (MobsIt& target : targets)
-		(*target)->hit(getDamage(), getDamageType());
+void LightningPetal::onHit(Mob& mob, MobSlots& mobs, std::list<std::unique_ptr<Effect>>& effects) {
+	std::vector<Mob*> targets = getTargets(mobs);
+	for (Mob* target : targets)
+		target->hit(getDamage(), getDamageType());
 
 
-	std::sort(targets.begin(), targets.end(), [](const MobsIt& a, const MobsIt& b) {
-		return (*a)->getPathPosition() < (*b)->getPathPosition();
+	std::sort(targets.begin(), targets.end(), [](const Mob* a, const Mob* b) {
+		return a->getPathPosition() < b->getPathPosition();
 		});
 
 	int connected = -1;
 	float connectedDst = 0.f;
 	std::vector<sf::Vector2f> positions(targets.size());
 	for (int i = 0; i < targets.size(); i++) {
-		auto& mob = *targets[i];
+		Mob* mob = targets[i];
 		positions[i] = mob->getPosition();
 
 		float dst = abs(mob->getPathPosition() - mob->getPathPosition());
@@ -352,67 +364,38 @@ void LightningPetal::onHit(Mob& mob, std::list<std::unique_ptr<Mob>>& mobs, std:
 }
 
 
-std::vector<std::list<std::unique_ptr<Mob>>::iterator> LightningPetal::getTargets(std::list<std::unique_ptr<Mob>>& mobs) const {
-	const float range = getAttrib("bounce_range") * MapInfo::squareSize.x;
-	const float rangeSq = range * range;
-	const int maxTargets = (int)(getAttrib("bounces"));
-	auto position = getPosition();
+std::vector<Mob*> LightningPetal::getTargets(MobSlots& mobs) const {
+	const float range = getAttrib(Attrib::BounceRange) * MapInfo::squareSize.x;
+	const int maxTargets = (int)(getAttrib(Attrib::Bounces));
 
-	std::vector<std::pair<
-		std::list<std::unique_ptr<Mob>>::iterator,
-		float>> best;
-
-	for (auto it = mobs.begin(); it != mobs.end(); it++) {
-		// Lightning cannot hit underground mobs
-		if (it->get()->isUnderground()) continue;
-
-		auto mp = (*it)->getPosition();
-		float dx = mp.x - position.x;
-		float dy = mp.y - position.y;
-		float d2 = dx * dx + dy * dy;
-		if (d2 > rangeSq) continue;
-
-		if (best.size() < maxTargets) {
-			best.emplace_back(it, d2);
-			int i = (int)best.size() - 1;
-			while (i > 0 && best[i].second < best[i - 1].second) {
-				std::swap(best[i], best[i - 1]);
-				i--;
-			}
-		}
-		else if (d2 < best.back().second) {
-			int i = (int)best.size() - 1;
-			while (i > 0 && best[i - 1].second > d2) {
-				best[i] = best[i - 1];
-				i--;
-			}
-			best[i] = std::pair{ it, d2 };
-		}
-	}
+	// Lightning cannot hit underground mobs, the query skips them
+	std::vector<MobHandle> handles;
+	m_info->mobQuery.kNearest(getPosition(), range, maxTargets, handles);
 
-	std::vector<std::list<std::unique_ptr<Mob>>::iterator> targets;
-	targets.reserve(best.size());
-	for (auto& p : best)
-		targets.push_back(p.first);
+	std::vector<Mob*> targets;
+	targets.reserve(handles.size());
+	for (MobHandle handle : handles)
+		if (Mob* mob = mobs.get(handle))
+			targets.push_back(mob);
 
 	return targets;
 }
 
 // Pincer (Shoot)
 void PincerPetal::applyDebuff(Debuff& debuff) const {
-	const std::string& rarity = getCard().rarity;
-	debuff.pincerSpeed.swap({ getAttrib("slow_down"), rarity, sf::seconds(getAttrib("slow_down_duration")) });
+	InternedString rarity = getCard().rarity;
+	debuff.pincerSpeed.swap({ getAttrib(Attrib::SlowDown), rarity, sf::seconds(getAttrib(Attrib::SlowDownDuration)) });
 }
 
 // Jelly (Defence)
 void JellyPetal::applyDebuff(Debuff& debuff) const {
-	const std::string& rarity = getCard().rarity;
-	debuff.knockback.swap({ getAttrib("knockback"), rarity });
+	InternedString rarity = getCard().rarity;
+	debuff.knockback.swap({ getAttrib(Attrib::Knockback), rarity });
 }
 
 // Dice (Shoot)
 int DicePetal::getDamage() const {
-	float boostProb = boostBaseProb + boostIncreasePerLuck * m_info->playerState.buff.luck.apply(0);
+	float boostProb = boostBaseProb + boostIncreasePerLuck * m_info->playerState.buff.apply<BuffType::Luck>(0);
 	if (randomUniform(0.f, 1.f) <= boostProb)
 		return ShootPetal::getDamage() * boostRate;
 	else
@@ -421,19 +404,19 @@ int DicePetal::getDamage() const {
 
 // Bur (Shoot)
 void BurPetal::applyDebuff(Debuff& debuff) const {
-	const std::string& rarity = getCard().rarity;
-	debuff.armor.swap({ getAttrib("armor_debuff"), rarity, sf::seconds(getAttrib("armor_debuff_duration")) });
+	InternedString rarity = getCard().rarity;
+	debuff.armor.swap({ getAttrib(Attrib::ArmorDebuff), rarity, sf::seconds(getAttrib(Attrib::ArmorDebuffDuration)) });
 }
 
 // Laser
-LaserPetal::LaserPetal(SharedInfo* info, const CardInfo& card, sf::Vector2i square, MapInfo& map, const std::list<std::unique_ptr<Mob>>& mobs)
-	: ShootPetal(info, card), m_square(square), m_map(map), m_mobs(mobs) {
+LaserPetal::LaserPetal(SharedInfo* info, const CardInfo& card, sf::Vector2i square, MapInfo& map, const MobSlots& mobs)
+	: ShootPetal(info, card, mobs), m_square(square), m_map(map) {
 
-	sf::Vector2f texSize = sf::Vector2f(m_sprite.getTexture().getSize());
+	sf::Vector2f texSize = sf::Vector2f(m_sprite.getTextureRect().size);
 
 	float length = MapInfo::squareSize.x;
 	float half = texSize.y / 2;
-	float scale = length * (getAttrib("radius") + 0.5f) / (texSize.x - half);
+	float scale = length * (getAttrib(Attrib::Radius) + 0.5f) / (texSize.x - half);
 	setScale(scale);
 
 	m_sprite.setOrigin({ half, half });
@@ -450,12 +433,12 @@ int LaserPetal::getArmor() const {
 }
 
 int LaserPetal::getDamage() const {
-	float damage = getBuffedAttrib("damage");
+	float damage = getStats().damage;
 
-	if (m_target.has_value()) {
+	if (getTarget()) {
 		float elapsed = m_timer.asSeconds();
-		float maxRate = getAttrib("max_damage_rate");
-		float increaseRate = std::min(maxRate, 1.f + getAttrib("damage_increase_rate") * elapsed);
+		float maxRate = getAttrib(Attrib::MaxDamageRate);
+		float increaseRate = std::min(maxRate, 1.f + getAttrib(Attrib::DamageIncreaseRate) * elapsed);
 		damage = damage * increaseRate;
 	}
 
@@ -485,52 +468,45 @@ void LaserPetal::update() {
 	updateTarget();
 
 	// Change phase
-	if (m_target.has_value())
-		m_sprite.setTexture(AssetManager::getPetalTexture("laser"));
+	if (getTarget())
+		setTexture(AssetManager::getPetalRegion("laser"));
 	else
-		m_sprite.setTexture(AssetManager::getPetalTexture("laser_idle"));
+		setTexture(AssetManager::getPetalRegion("laser_idle"));
 }
 
 void LaserPetal::updatePosition() {}
 
 void LaserPetal::updateTarget() {
-	float range = getAttrib("radius") * MapInfo::squareSize.x;
+	float range = getAttrib(Attrib::Radius) * MapInfo::squareSize.x;
 	float rangeSquared = range * range;
 	auto position = getPosition();
 
-	if (m_target.has_value()) {
+	if (const Mob* target = getTarget()) {
 		// If target is out of range
-		float distSquared = getDistanceSquare(position, m_target.value()->get()->getPosition());
-		if (distSquared > rangeSquared || m_target.value()->get()->isUnderground())
+		float distSquared = getDistanceSquare(position, target->getPosition());
+		if (distSquared > rangeSquared || target->isUnderground())
 			lostTarget();
 		else
 			return;
 	}
 
-	std::optional<std::list<std::unique_ptr<Mob>>::const_iterator> nearestMob;
-	float nearestDistSquared = std::numeric_limits<float>::max();
-
-	for (auto it = m_mobs.begin(); it != m_mobs.end(); it++) {
-		// Cannot target underground mobs
-		if (it->get()->isUnderground()) continue;
-
-		float distSquared = getDistanceSquare(position, it->get()->getPosition());
-
-		if (distSquared <= rangeSquared && distSquared < nearestDistSquared) {
-			nearestDistSquared = distSquared;
-			nearestMob = it;
-		}
-	}
+	// Follow the laser tower's target mode
+	const Tower* tower = m_map.getTower(m_square);
+	TargetMode mode = tower ? tower->getTargetMode() : TargetMode::Nearest;
+	if (mode == TargetMode::Nearest)
+		m_info->mobQuery.kNearest(position, range, 1, m_candidates);
+	else
+		m_info->pathIndex.query(m_coverage.get(position, range), position, range, mode, 1, m_candidates);
 
-	if (nearestMob.has_value()) {
-		m_target = nearestMob;
+	if (!m_candidates.empty()) {
+		m_target = m_candidates.front();
 		m_timer = sf::Time::Zero;
 	}
 }
 
 // Chip Petal
 int ChipPetal::getArmor() const {
-	if (randomUniform(0.f, 1.f) <= getAttrib("evasion"))
+	if (randomUniform(0.f, 1.f) <= getAttrib(Attrib::Evasion))
 		return INF;
 	else
 		return 0;
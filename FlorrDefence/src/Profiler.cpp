@@ -0,0 +1,162 @@
+#include "Profiler.hpp"
+#include <iostream>
+#include <fstream>
+#include <format>
+#include <algorithm>
+#include <nlohmann/json.hpp>
+
+std::string_view profilePhaseToString(ProfilePhase phase) {
+    switch (phase) {
+    case ProfilePhase::HandleEvents: return "handle_events";
+    case ProfilePhase::Spawner: return "spawner";
+    case ProfilePhase::MobUpdate: return "mob_update";
+    case ProfilePhase::TowerUpdate: return "tower_update";
+    case ProfilePhase::PetalUpdate: return "petal_update";
+    case ProfilePhase::Collision: return "collision";
+    case ProfilePhase::TowerTick: return "tower_tick";
+    case ProfilePhase::DeadEntities: return "dead_entities";
+    case ProfilePhase::MapDraw: return "map_draw";
+    case ProfilePhase::UIDraw: return "ui_draw";
+    case ProfilePhase::RecordSave: return "record_save";
+    default: return "unknown";
+    }
+}
+
+static double toMs(int64_t ns) {
+    return ns / 1'000'000.0;
+}
+
+Profiler& Profiler::getInstance() {
+    static Profiler instance;
+    return instance;
+}
+
+void Profiler::add(ProfilePhase phase, std::chrono::nanoseconds time) {
+    Profiler& p = getInstance();
+    p.m_current[(size_t)phase] += time.count();
+    p.m_totals[(size_t)phase] += time.count();
+}
+
+void Profiler::endFrame() {
+    if (!s_enabled)
+        return;
+
+    Profiler& p = getInstance();
+    if (p.m_frames.size() < frameCapacity)
+        p.m_frames.push_back(p.m_current);
+    else
+        p.m_frames[p.m_next] = p.m_current;
+
+    p.m_next = (p.m_next + 1) % frameCapacity;
+    p.m_current = {};
+}
+
+void Profiler::reset() {
+    Profiler& p = getInstance();
+    p.m_current = {};
+    p.m_totals = {};
+    p.m_frames.clear();
+    p.m_next = 0;
+}
+
+std::chrono::nanoseconds Profiler::getTotal(ProfilePhase phase) {
+    return std::chrono::nanoseconds(getInstance().m_totals[(size_t)phase]);
+}
+
+size_t Profiler::getFrameCount() {
+    return getInstance().m_frames.size();
+}
+
+template <typename Fn>
+void Profiler::forEachFrame(Fn fn) const {
+    // Until the buffer is full m_next is its size, so the oldest frame is at 0
+    size_t start = m_frames.size() < frameCapacity ? 0 : m_next;
+    for (size_t i = 0; i < m_frames.size(); i++)
+        fn(m_frames[(start + i) % m_frames.size()]);
+}
+
+std::vector<Profiler::Summary> Profiler::summarize() {
+    const Profiler& p = getInstance();
+    std::vector<Summary> result;
+    if (p.m_frames.empty())
+        return result;
+
+    std::vector<int64_t> samples(p.m_frames.size());
+    for (size_t phase = 0; phase < phaseCount; phase++) {
+        int64_t total = 0;
+        for (size_t i = 0; i < p.m_frames.size(); i++) {
+            samples[i] = p.m_frames[i][phase];
+            total += samples[i];
+        }
+
+        // Nearest rank
+        size_t rank = (samples.size() * 99 + 99) / 100 - 1;
+        std::nth_element(samples.begin(), samples.begin() + rank, samples.end());
+        int64_t p99 = samples[rank];
+
+        result.push_back({
+            (ProfilePhase)phase,
+            toMs(*std::min_element(samples.begin(), samples.end())),
+            toMs(total) / samples.size(),
+            toMs(p99)
+        });
+    }
+
+    return result;
+}
+
+void Profiler::print() {
+    std::cout << std::format("Profile of the last {} frames (ms):", getFrameCount()) << std::endl;
+    for (const Summary& s : summarize())
+        std::cout << std::format("  {:<14} min {:>8.3f}  avg {:>8.3f}  p99 {:>8.3f}",
+            profilePhaseToString(s.phase), s.minMs, s.avgMs, s.p99Ms) << std::endl;
+}
+
+bool Profiler::exportToFile(const std::filesystem::path& path) {
+    std::ofstream ofs(path);
+    if (!ofs.is_open()) {
+        std::cerr << std::format("Failed to open '{}' for the profile.", path.string()) << std::endl;
+        return false;
+    }
+
+    const Profiler& p = getInstance();
+    bool ok = path.extension() == ".csv" ? p.exportCsv(ofs) : p.exportJson(ofs);
+    if (ok)
+        std::cout << std::format("Profile of {} frames written to '{}'.", getFrameCount(), path.string()) << std::endl;
+    return ok;
+}
+
+bool Profiler::exportCsv(std::ostream& os) const {
+    os << "frame";
+    for (size_t phase = 0; phase < phaseCount; phase++)
+        os << ',' << profilePhaseToString((ProfilePhase)phase) << "_ms";
+    os << '\n';
+
+    size_t index = 0;
+    forEachFrame([&](const Frame& frame) {
+        os << index++;
+        for (int64_t ns : frame)
+            os << ',' << toMs(ns);
+        os << '\n';
+    });
+
+    return (bool)os;
+}
+
+bool Profiler::exportJson(std::ostream& os) const {
+    nlohmann::json j;
+    j["frames"] = m_frames.size();
+
+    for (const Summary& s : summarize()) {
+        std::string name(profilePhaseToString(s.phase));
+        j["summary"][name] = { {"min_ms", s.minMs}, {"avg_ms", s.avgMs}, {"p99_ms", s.p99Ms} };
+    }
+
+    forEachFrame([&](const Frame& frame) {
+        for (size_t phase = 0; phase < phaseCount; phase++)
+            j["samples_ms"][std::string(profilePhaseToString((ProfilePhase)phase))].push_back(toMs(frame[phase]));
+    });
+
+    os << j.dump(2) << std::endl;
+    return (bool)os;
+}
@@ -3,8 +3,13 @@
 #include <iostream>
 #include <fstream>
 #include <format>
+#include <iterator>
+#include <algorithm>
 
 #include "Game.hpp"
+#include "Profiler.hpp"
+#include "BinaryRecord.hpp"
+#include "RecordSnapshot.hpp"
 
 Record& Record::instance() {
 	static Record record;
@@ -19,7 +24,10 @@ bool Record::try_load(Game& game, const std::filesystem::path& path) {
 
 	std::cout << std::format("Looking for game record from '{}'", path.string()) << std::endl;
 
-	std::ifstream ifs(path);
+	// A background save may still be writing it
+	waitForSave();
+
+	std::ifstream ifs(path, std::ios::binary);
 
 	if (!ifs.is_open()) {
 		std::cout << "Record not found, start a new game." << std::endl;
@@ -29,13 +37,15 @@ bool Record::try_load(Game& game, const std::filesystem::path& path) {
 	std::cout << "Loading game record..." << std::endl;
 
 	try {
-		m_data.clear();
-		ifs >> m_data;
+		RecordSnapshot record = parse(ifs);
+
+		if (size_t saves = RecordJournal::replay(record, path); saves > 0)
+			std::cout << std::format("Replayed {} journaled saves", saves) << std::endl;
+
+		// Saving again starts from a new checkpoint, which folds the journal in
+		m_journal.reset();
 
-		m_data["player"].get_to(game.m_info.playerState);
-		m_data["map"].get_to(game.m_map);
-		m_data["shop"].get_to(game.m_ui.m_shop);
-		m_data["talent"].get_to(game.m_ui.m_talent);
+		restore(game, record);
 
 		auto& uniques = game.m_info.playerState.aquiredUniques;
 
@@ -58,40 +68,246 @@ bool Record::try_load(Game& game, const std::filesystem::path& path) {
 }
 
 void Record::save(Game& game, const std::filesystem::path& path) {
+	PROFILE_SCOPE(ProfilePhase::RecordSave);
+
 	if (path.empty()) {
 		std::cout << "Target saving file is empty, do not save by default." << std::endl;
 		return;
 	}
 
+	// A background save may be writing the same file
+	waitForSave();
+
 	std::cout << "Saving game..." << std::endl;
 
+	try {
+		bool withBackpack = m_journal.needsBackpack(path, game.m_info.playerState.backpack.getVersion());
+		m_journal.save(capture(game, withBackpack), path);
+
+		std::cout << std::format(
+			"Game successfully saved to '{}'",
+			path.string()
+		) << std::endl;
+	}
+	catch (const std::exception& e) {
+		std::cerr << "Failed to save record: " << e.what() << std::endl;
+	}
+}
+
+bool Record::saveAsync(Game& game, const std::filesystem::path& path) {
+	if (path.empty()) {
+		std::cout << "Target saving file is empty, do not save by default." << std::endl;
+		return false;
+	}
+
+	if (isSaving()) {
+		std::cout << "[WARNING] Previous save still in progress, skipping this one." << std::endl;
+		return false;
+	}
+
+	RecordSnapshot snapshot;
+	{
+		// Only the snapshot runs on the main thread
+		PROFILE_SCOPE(ProfilePhase::RecordSave);
+		bool withBackpack = m_journal.needsBackpack(path, game.m_info.playerState.backpack.getVersion());
+		snapshot = capture(game, withBackpack);
+	}
+
+	m_pendingSave = std::async(std::launch::async, [this, snapshot = std::move(snapshot), path]() mutable {
+		auto start = std::chrono::steady_clock::now();
+
+		SaveResult result;
+		result.path = path;
+
+		try {
+			m_journal.save(std::move(snapshot), path);
+			result.success = true;
+		}
+		catch (const std::exception& e) {
+			result.error = e.what();
+		}
+
+		result.duration = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+		return result;
+	});
+
+	return true;
+}
+
+std::optional<Record::SaveResult> Record::pollSave() {
+	if (!m_pendingSave.valid() || isSaving())
+		return std::nullopt;
+	return m_pendingSave.get();
+}
+
+bool Record::isSaving() const {
+	return m_pendingSave.valid() && m_pendingSave.wait_for(std::chrono::seconds(0)) != std::future_status::ready;
+}
+
+void Record::waitForSave() const {
+	if (m_pendingSave.valid())
+		m_pendingSave.wait();
+}
+
+RecordSnapshot Record::capture(Game& game, bool withBackpack) {
+	RecordSnapshot snapshot;
+
+	const PlayerState& player = game.m_info.playerState;
+	snapshot.player = {
+		player.hpLimit,
+		player.hp,
+		player.shield,
+		player.xp,
+		player.bodyDamage,
+		player.level,
+		player.coin,
+		player.talent
+	};
+
+	// Kept in the record only, the live backpack gets the card back when the drag ends
+	std::optional<CardInfo> dragged;
 	if (game.m_info.draggedCard.has_value()) {
 		std::cout << "[WARNING] Saving game while dragging a card!" << std::endl;
-		game.m_info.playerState.backpack.add({ game.m_info.draggedCard->getCard(), 1 });
+		dragged = game.m_info.draggedCard->getCard();
 	}
+	snapshot.setBackpack(player.backpack, withBackpack, dragged);
 
-	try {
-		m_data.clear();
-		m_data["player"] = game.m_info.playerState;
-		m_data["map"] = game.m_map;
-		m_data["shop"] = game.m_ui.m_shop;
-		m_data["talent"] = game.m_ui.m_talent;
+	const MapInfo& map = game.m_map.getMapInfo();
+	for (int x = 0; x < MAP_HEIGHT; x++) {
+		for (int y = 0; y < MAP_WIDTH; y++) {
+			const Tower* tower = map.getTower({ x, y });
+			if (!tower)
+				continue;
+
+			std::optional<TargetMode> targetMode;
+			if (tower->hasTargetMode())
+				targetMode = tower->getTargetMode();
+			snapshot.towers.push_back({ { x, y }, tower->getCard(), tower->getReloadTimer(), targetMode });
+		}
+	}
 
-		std::ofstream ofs(path);
+	snapshot.mobs.reserve(game.m_map.getMobs().size());
+	for (const std::unique_ptr<Mob>& mob : game.m_map.getMobs())
+		snapshot.mobs.push_back({ mob->getMob(), mob->getHp(), mob->getPathPosition() });
 
-		if (!ofs.is_open()) {
-			std::cerr << "Failed to save record to " << path << std::endl;
-			return;
+	for (const auto& [rarity, shop] : game.m_ui.m_shop.getShops())
+		snapshot.shops[rarity] = { shop.m_products, shop.m_productCountCache, shop.m_refreshTimer };
+	snapshot.talentNodes = game.m_ui.m_talent.getActivatedNodes();
+
+	return snapshot;
+}
+
+void Record::restore(Game& game, const RecordSnapshot& record) {
+	restore(game.m_info, game.m_map, record);
+
+	for (auto& [rarity, shop] : game.m_ui.m_shop.m_shops) {
+		auto it = record.shops.find(rarity);
+		if (it == record.shops.end())
+			continue;
+		shop.m_products = it->second.products;
+		shop.m_productCountCache = it->second.productCountCache;
+		shop.m_refreshTimer = it->second.refreshTimer;
+	}
+
+	for (int node : record.talentNodes)
+		game.m_ui.m_talent.buyTalent(node, true);
+}
+
+void Record::restore(SharedInfo& info, Map& map, const RecordSnapshot& record) {
+	PlayerState& player = info.playerState;
+	player.init();
+
+	player.hpLimit = player.prevHpLimit = record.player.hpLimit;
+	player.hp = std::clamp(record.player.hp, 0, record.player.hpLimit);
+	player.shield = record.player.shield;
+	player.xp = record.player.xp;
+	player.bodyDamage = record.player.bodyDamage;
+	player.level = record.player.level;
+	player.coin = record.player.coin;
+	player.talent = record.player.talent;
+	player.backpack = record.backpack.value_or(BackpackInfo{});
+
+	MapInfo& mapInfo = map.getMapInfo();
+	mapInfo.clear();
+	for (const RecordSnapshot::Tower& t : record.towers) {
+		mapInfo.setCard(t.square, t.card);
+		Tower* tower = mapInfo.getTower(t.square);
+		tower->m_reloadTimer = t.reloadTimer;
+		tower->m_targetMode = t.targetMode.value_or(TargetMode::Nearest);
+	}
+
+	for (const RecordSnapshot::Mob& m : record.mobs) {
+		std::unique_ptr<Mob> mob = Mob::create(&info, m.card, map.getMobs());
+		mob->m_hp = m.hp;
+		mob->m_position = m.position;
+		map.getMobs().push_back(std::move(mob));
+	}
+}
+
+void Record::writeFile(const RecordSnapshot& record, const std::filesystem::path& path) {
+	std::filesystem::path temp = path;
+	temp += ".tmp";
+
+	{
+		std::ofstream ofs(temp, std::ios::binary);
+
+		if (!ofs.is_open())
+			throw std::runtime_error(std::format("Failed to open '{}'", temp.string()));
+
+		write(ofs, record, getFormat(path));
+	}
+
+	std::filesystem::rename(temp, path);
+}
+
+RecordFormat Record::getFormat(const std::filesystem::path& path) {
+	return path.extension() == binaryExtension ? RecordFormat::Binary : RecordFormat::Json;
+}
+
+RecordSnapshot Record::parse(std::istream& is) {
+	std::string bytes(std::istreambuf_iterator<char>(is), {});
+
+	if (BinaryRecord::isBinary(bytes))
+		return BinaryRecord::decode(bytes);
+	return json::parse(bytes).get<RecordSnapshot>();
+}
+
+void Record::write(std::ostream& os, const RecordSnapshot& record, RecordFormat format) {
+	if (format == RecordFormat::Binary) {
+		std::string bytes = BinaryRecord::encode(record);
+		os.write(bytes.data(), (std::streamsize)bytes.size());
+	}
+	else {
+		os << json(record).dump(4);
+	}
+
+	if (!os)
+		throw std::runtime_error("Failed to write record");
+}
+
+bool Record::convert(const std::filesystem::path& from, const std::filesystem::path& to) {
+	try {
+		std::ifstream ifs(from, std::ios::binary);
+		if (!ifs.is_open()) {
+			std::cerr << std::format("Record '{}' not found.", from.string()) << std::endl;
+			return false;
 		}
+		RecordSnapshot record = parse(ifs);
+		RecordJournal::replay(record, from);
+		record.checkpointId = 0;
 
-		ofs << m_data.dump(4);
+		std::ofstream ofs(to, std::ios::binary);
+		if (!ofs.is_open()) {
+			std::cerr << "Failed to save record to " << to << std::endl;
+			return false;
+		}
+		write(ofs, record, getFormat(to));
 
-		std::cout << std::format(
-			"Game successfully saved to '{}'",
-			path.string()
-		) << std::endl;
+		std::cout << std::format("Converted '{}' to '{}'", from.string(), to.string()) << std::endl;
+		return true;
 	}
 	catch (const std::exception& e) {
-		std::cerr << "Failed to save record: " << e.what() << std::endl;
+		std::cerr << "Failed to convert record: " << e.what() << std::endl;
+		return false;
 	}
 }
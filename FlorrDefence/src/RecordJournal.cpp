@@ -0,0 +1,248 @@
+#include "RecordJournal.hpp"
+
+#include <iostream>
+#include <fstream>
+#include <format>
+#include <iterator>
+#include <random>
+#include <algorithm>
+#include <cstring>
+
+#include "Record.hpp"
+#include "BinaryRecord.hpp"
+#include "Constants.hpp"
+
+static constexpr size_t headerSize = 14;
+
+static uint32_t fnv1a(std::string_view bytes) {
+	uint32_t hash = 2166136261u;
+	for (char c : bytes) {
+		hash ^= (unsigned char)c;
+		hash *= 16777619u;
+	}
+	return hash;
+}
+
+static uint64_t makeCheckpointId() {
+	std::random_device rd;
+	uint64_t id = ((uint64_t)rd() << 32) | rd();
+	return id != 0 ? id : 1;  // 0 means no checkpoint
+}
+
+static bool isSameTowers(const std::vector<RecordSnapshot::Tower>& a, const std::vector<RecordSnapshot::Tower>& b) {
+	return std::equal(a.begin(), a.end(), b.begin(), b.end(), [](const auto& x, const auto& y) {
+		return x.square == y.square && x.card == y.card && x.targetMode == y.targetMode;
+	});
+}
+
+static bool isSameShops(const std::unordered_map<std::string, RecordSnapshot::Shop>& a, const std::unordered_map<std::string, RecordSnapshot::Shop>& b) {
+	if (a.size() != b.size())
+		return false;
+
+	for (const auto& [rarity, shop] : a) {
+		auto it = b.find(rarity);
+		if (it == b.end() || !shop.hasSameStock(it->second))
+			return false;
+	}
+	return true;
+}
+
+static std::vector<RecordSection> getDirtySections(const RecordSnapshot& saved, const RecordSnapshot& current) {
+	std::vector<RecordSection> dirty;
+
+	if (current.player != saved.player)
+		dirty.push_back(RecordSection::Player);
+	if (current.backpack)  // Only captured when its version changed
+		dirty.push_back(RecordSection::Backpack);
+	if (!isSameTowers(current.towers, saved.towers))
+		dirty.push_back(RecordSection::Towers);
+	if (current.mobs != saved.mobs)
+		dirty.push_back(RecordSection::Mobs);
+	if (!isSameShops(current.shops, saved.shops))
+		dirty.push_back(RecordSection::Shop);
+	if (current.talentNodes != saved.talentNodes)
+		dirty.push_back(RecordSection::Talent);
+
+	return dirty;
+}
+
+std::filesystem::path RecordJournal::getPath(const std::filesystem::path& record) {
+	std::filesystem::path path = record;
+	path += extension;
+	return path;
+}
+
+bool RecordJournal::needsBackpack(const std::filesystem::path& record, uint64_t backpackVersion) const {
+	return !SAVE_JOURNAL_ENABLED || !m_saved || m_record != record || m_saved->backpackVersion != backpackVersion;
+}
+
+void RecordJournal::save(RecordSnapshot snapshot, const std::filesystem::path& record) {
+	try {
+		bool continueJournal = SAVE_JOURNAL_ENABLED && m_saved && m_record == record && m_checkpointId != 0;
+
+		std::vector<RecordSection> dirty;
+		if (continueJournal)
+			dirty = getDirtySections(*m_saved, snapshot);
+
+		if (!snapshot.backpack) {
+			if (!continueJournal)
+				throw std::runtime_error("snapshot without a backpack for a new checkpoint");
+			snapshot.backpack = std::move(m_saved->backpack);
+			snapshot.backpackVersion = m_saved->backpackVersion;
+		}
+
+		// Untouched sections only differ by their timers, the snapshot has the current ones for the next checkpoint
+		m_saved = std::move(snapshot);
+		m_record = record;
+
+		if (!continueJournal || m_journalSize > std::max(m_checkpointSize, minCompactSize))
+			writeCheckpoint();
+		else if (!dirty.empty())
+			append(dirty);
+	}
+	catch (...) {
+		reset();
+		throw;
+	}
+}
+
+void RecordJournal::reset() {
+	m_saved.reset();
+	m_record.clear();
+	m_checkpointId = 0;
+	m_checkpointSize = 0;
+	m_journalSize = 0;
+}
+
+void RecordJournal::writeCheckpoint() {
+	m_checkpointId = SAVE_JOURNAL_ENABLED ? makeCheckpointId() : 0;
+	m_saved->checkpointId = m_checkpointId;
+
+	Record::writeFile(*m_saved, m_record);
+	m_checkpointSize = std::filesystem::file_size(m_record);
+
+	std::filesystem::path journal = getPath(m_record);
+	if (m_checkpointId == 0) {
+		std::error_code ec;
+		std::filesystem::remove(journal, ec);
+		m_journalSize = 0;
+		return;
+	}
+
+	// After the checkpoint, until replaced the old journal doesn't match it and is ignored
+	BinaryWriter header;
+	header.bytes(std::string_view(magic, sizeof(magic)));
+	header.u16(version);
+	header.i64((int64_t)m_checkpointId);
+
+	std::filesystem::path temp = journal;
+	temp += ".tmp";
+	{
+		std::ofstream ofs(temp, std::ios::binary);
+		if (!ofs.is_open())
+			throw std::runtime_error(std::format("Failed to open '{}'", temp.string()));
+		ofs.write(header.data().data(), (std::streamsize)header.size());
+		if (!ofs)
+			throw std::runtime_error("Failed to write journal header");
+	}
+	std::filesystem::rename(temp, journal);
+	m_journalSize = header.size();
+}
+
+void RecordJournal::append(const std::vector<RecordSection>& sections) {
+	BinaryWriter payload;
+	payload.u8((uint8_t)sections.size());
+	for (RecordSection section : sections) {
+		std::vector<uint8_t> bytes = json::to_msgpack(m_saved->getSection(section));
+		payload.u8((uint8_t)section);
+		payload.u32((uint32_t)bytes.size());
+		payload.bytes(std::string_view((const char*)bytes.data(), bytes.size()));
+	}
+
+	BinaryWriter frame;
+	frame.u32((uint32_t)payload.size());
+	frame.u32(fnv1a(payload.data()));
+	frame.bytes(payload.data());
+
+	std::filesystem::path journal = getPath(m_record);
+
+	// Cut what an interrupted append left behind
+	if (std::filesystem::file_size(journal) != m_journalSize)
+		std::filesystem::resize_file(journal, m_journalSize);
+
+	std::ofstream ofs(journal, std::ios::binary | std::ios::app);
+	if (!ofs.is_open())
+		throw std::runtime_error(std::format("Failed to open '{}'", journal.string()));
+
+	ofs.write(frame.data().data(), (std::streamsize)frame.size());
+	ofs.flush();
+	if (!ofs)
+		throw std::runtime_error("Failed to append to the journal");
+
+	m_journalSize += frame.size();
+}
+
+size_t RecordJournal::replay(RecordSnapshot& record, const std::filesystem::path& path) {
+	uint64_t checkpointId = record.checkpointId;
+	if (checkpointId == 0)
+		return 0;
+
+	std::ifstream ifs(getPath(path), std::ios::binary);
+	if (!ifs.is_open())
+		return 0;
+
+	std::string bytes(std::istreambuf_iterator<char>(ifs), {});
+	if (bytes.size() < headerSize || std::memcmp(bytes.data(), magic, sizeof(magic)) != 0) {
+		std::cerr << "[WARNING] Journal header is damaged, ignoring it." << std::endl;
+		return 0;
+	}
+
+	BinaryReader reader(bytes);
+	reader.bytes(sizeof(magic));
+
+	uint16_t fileVersion = reader.u16();
+	if (fileVersion > version) {
+		std::cerr << std::format("[WARNING] Journal version {} is newer than the supported version {}, ignoring it.", fileVersion, version) << std::endl;
+		return 0;
+	}
+
+	if ((uint64_t)reader.i64() != checkpointId) {
+		std::cout << "Journal belongs to an older checkpoint, ignoring it." << std::endl;
+		return 0;
+	}
+
+	size_t saves = 0;
+	while (!reader.atEnd()) {
+		try {
+			uint32_t size = reader.u32();
+			uint32_t checksum = reader.u32();
+			std::string_view payload = reader.bytes(size);
+			if (fnv1a(payload) != checksum)
+				throw std::runtime_error("checksum mismatch");
+
+			// Decoded whole before anything is applied, a save is replayed entirely or not at all
+			BinaryReader p(payload);
+			RecordSnapshot decoded;
+			std::vector<RecordSection> sections;
+			uint8_t count = p.u8();
+			for (uint8_t i = 0; i < count; i++) {
+				uint8_t section = p.u8();
+				if (section >= (uint8_t)RecordSection::Count)
+					throw std::runtime_error(std::format("unknown section {}", section));
+				std::string_view value = p.bytes(p.u32());
+				decoded.setSection((RecordSection)section, json::from_msgpack(value.begin(), value.end()));
+				sections.push_back((RecordSection)section);
+			}
+
+			for (RecordSection section : sections)
+				record.takeSection(section, decoded);
+			saves++;
+		}
+		catch (const std::exception& e) {
+			std::cerr << std::format("[WARNING] Journal ends in a damaged save ({}), ignoring the rest.", e.what()) << std::endl;
+			break;
+		}
+	}
+
+	return saves;
+}
@@ -0,0 +1,121 @@
+#include "RecordSnapshot.hpp"
+
+#include <stdexcept>
+
+std::string_view recordSectionToString(RecordSection section) {
+	switch (section) {
+	case RecordSection::Player:   return "player";
+	case RecordSection::Backpack: return "backpack";
+	case RecordSection::Towers:   return "towers";
+	case RecordSection::Mobs:     return "mobs";
+	case RecordSection::Shop:     return "shop";
+	case RecordSection::Talent:   return "talent";
+	default:                      return "unknown";
+	}
+}
+
+void RecordSnapshot::setBackpack(const BackpackInfo& live, bool withBackpack, const std::optional<CardInfo>& dragged) {
+	backpackVersion = live.getVersion();
+	if (!withBackpack && !dragged)
+		return;
+
+	backpack = live;
+	if (dragged) {
+		backpack->add({ *dragged, 1 });
+		backpackVersion = backpack->getVersion();
+	}
+}
+
+json RecordSnapshot::getSection(RecordSection section) const {
+	switch (section) {
+	case RecordSection::Player:   return player;
+	case RecordSection::Backpack: return backpack.value();
+	case RecordSection::Towers:   return towers;
+	case RecordSection::Mobs:     return mobs;
+	case RecordSection::Shop:     return shops;
+	case RecordSection::Talent:   return { { "activated_nodes", talentNodes } };
+	default:                      throw std::runtime_error("invalid record section");
+	}
+}
+
+void RecordSnapshot::setSection(RecordSection section, const json& value) {
+	switch (section) {
+	case RecordSection::Player:   value.get_to(player); break;
+	case RecordSection::Backpack: backpack = value.get<BackpackInfo>(); break;
+	case RecordSection::Towers:   value.get_to(towers); break;
+	case RecordSection::Mobs:     value.get_to(mobs); break;
+	case RecordSection::Shop:     value.get_to(shops); break;
+	case RecordSection::Talent:   talentNodes = value.value<std::vector<int>>("activated_nodes", {}); break;
+	default:                      throw std::runtime_error("invalid record section");
+	}
+}
+
+void RecordSnapshot::takeSection(RecordSection section, RecordSnapshot& other) {
+	switch (section) {
+	case RecordSection::Player:   player = other.player; break;
+	case RecordSection::Backpack: backpack = std::move(other.backpack); break;
+	case RecordSection::Towers:   towers = std::move(other.towers); break;
+	case RecordSection::Mobs:     mobs = std::move(other.mobs); break;
+	case RecordSection::Shop:     shops = std::move(other.shops); break;
+	case RecordSection::Talent:   talentNodes = std::move(other.talentNodes); break;
+	default:                      throw std::runtime_error("invalid record section");
+	}
+}
+
+void applyRecordSection(json& record, RecordSection section, json value) {
+	switch (section) {
+	case RecordSection::Player:
+		// Merged, the backpack lives in the same object
+		record["player"].update(value);
+		break;
+	case RecordSection::Backpack:
+		record["player"]["backpack"] = std::move(value);
+		break;
+	case RecordSection::Towers:
+		record["map"]["info"]["towers"] = std::move(value);
+		break;
+	case RecordSection::Mobs:
+		record["map"]["mobs"] = std::move(value);
+		break;
+	case RecordSection::Shop:
+		record["shop"] = std::move(value);
+		break;
+	case RecordSection::Talent:
+		record["talent"] = std::move(value);
+		break;
+	default:
+		throw std::runtime_error("invalid record section");
+	}
+}
+
+void to_json(json& j, const RecordSnapshot& s) {
+	for (size_t i = 0; i < (size_t)RecordSection::Count; i++)
+		applyRecordSection(j, (RecordSection)i, s.getSection((RecordSection)i));
+
+	if (s.checkpointId != 0)
+		j["checkpoint"] = s.checkpointId;
+}
+
+void from_json(const json& j, RecordSnapshot& s) {
+	s = {};
+
+	if (auto player = j.find("player"); player != j.end()) {
+		s.setSection(RecordSection::Player, *player);
+		if (auto backpack = player->find("backpack"); backpack != player->end())
+			s.setSection(RecordSection::Backpack, *backpack);
+	}
+
+	if (auto map = j.find("map"); map != j.end()) {
+		if (auto info = map->find("info"); info != map->end() && info->contains("towers"))
+			s.setSection(RecordSection::Towers, info->at("towers"));
+		if (auto mobs = map->find("mobs"); mobs != map->end())
+			s.setSection(RecordSection::Mobs, *mobs);
+	}
+
+	if (auto shop = j.find("shop"); shop != j.end())
+		s.setSection(RecordSection::Shop, *shop);
+	if (auto talent = j.find("talent"); talent != j.end())
+		s.setSection(RecordSection::Talent, *talent);
+
+	s.checkpointId = j.value("checkpoint", uint64_t{ 0 });
+}
@@ -21,6 +21,7 @@ void BackpackInfo::add(const CardStackInfo& stack) {
     m_count[stack.card] += stack.count;
     m_rarityCount[stack.card.rarity] += stack.count;
     m_typeCount[stack.card.type] += stack.count;
+    m_version = ++s_lastVersion;
 }
 
 // PlayerState
@@ -46,14 +47,14 @@ bool PlayerState::isAlive() const {
 }
 
 int PlayerState::getBodyDamage() const {
-    return (int)buff.bodyDamage.apply((float)bodyDamage);
+    return (int)buff.apply<BuffType::BodyDamage>((float)bodyDamage);
 }
 
 void PlayerState::hit(int damage, const MobInfo& mob) {
-    if (randomUniform(0.f, 1.f) <= buff.evasion.apply(1.f))
+    if (randomUniform(0.f, 1.f) <= buff.apply<BuffType::Evasion>(1.f))
         return;  // evasion
 
-    damage = (int)ceil(buff.damage_reduction.apply((float)damage));
+    damage = (int)ceil(buff.apply<BuffType::DamageReduction>((float)damage));
 
     if (shield > 0) {
         int obsorbed = std::min(damage, shield);
@@ -77,7 +78,7 @@ void PlayerState::heal(float amount) {
     hp = std::min(hp, hpLimit);
     actuall_amount -= heal;
     if (actuall_amount > 0) 
-        addShield(buff.overheal.apply((float)actuall_amount));
+        addShield(buff.apply<BuffType::Overheal>((float)actuall_amount));
 }
 
 void PlayerState::addShield(float amount) {
@@ -112,7 +113,7 @@ void PlayerState::update() {
     hp = std::min(hp, hpLimit);
     shield = std::max(0, std::min(shield, hp));
 
-    hpLimit = (int)buff.health.apply((float)originalHpLimit);
+    hpLimit = (int)buff.apply<BuffType::Health>((float)originalHpLimit);
     if (hpLimit != prevHpLimit) {
         double hpPrecent = (double)hp / prevHpLimit;
         double shieldPrecent = (double)shield / prevHpLimit;
@@ -123,7 +124,7 @@ void PlayerState::update() {
 }
 
 void PlayerState::applyHealValueBuff(sf::Time dt) {
-    heal(buff.healValue.apply(0) * dt.asSeconds());
+    heal(buff.apply<BuffType::HealValue>(0) * dt.asSeconds());
 }
 
 // Input
@@ -153,16 +154,24 @@ bool SharedInfo::update(const sf::RenderWindow& window) {
     sf::Vector2i mousePixelPos = sf::Mouse::getPosition(window);
     mouseWorldPosition = window.mapPixelToCoords(mousePixelPos);
     input.update();
-    playerState.update();
 
-    dt = dtClock.restart();
-    if (dt > TICK)
+    sf::Time elapsed = dtClock.restart();
+    if (elapsed > TICK)
         // If a frame is so long, this is usually cause by dragging/resizing window
         // To prevent from sudden movements, we clamp frame to a tick
-        dt = TICK;
+        elapsed = TICK;
+
+    return update(elapsed);
+}
+
+bool SharedInfo::update(sf::Time elapsed) {
+    playerState.update();
+
+    frameDt = elapsed;
+    dt = SIM_STEP;
 
     if (playerState.isAlive() && draggedCard.has_value()) {
-        if (draggedCard->update(mouseWorldPosition, dt)) {
+        if (draggedCard->update(mouseWorldPosition, frameDt)) {
             playerState.backpack.add({ draggedCard->getCard(), 1 });
             draggedCard.reset();
             return true;
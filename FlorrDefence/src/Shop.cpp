@@ -127,7 +127,7 @@ ShopInfo::ShopInfo(const SharedInfo* info, const std::string& type)
 }
 
 bool ShopInfo::update() {
-	m_refreshTimer += m_info->dt;
+	m_refreshTimer += m_info->frameDt;
 
 	if (m_refreshTimer >= SHOP_ATTRIBS[m_type].refreshInterval) {
 		refresh();
@@ -159,7 +159,7 @@ Shop::Shop(SharedInfo* info)
 void Shop::update() {
 	// Menu
 	for (int i = 0; i < m_menu.getSize(); i++) {
-		bool disable = RARITIE_LEVELS.at(SHOP_RARITIES[i]) > (int)round(m_info->playerState.buff.shop.apply(1));
+		bool disable = RARITIE_LEVELS.at(SHOP_RARITIES[i]) > (int)round(m_info->playerState.buff.apply<BuffType::Shop>(1));
 		m_menu.getButton(i).setDisabled(disable);
 	}
 	m_menu.update(m_info->mouseWorldPosition);
@@ -209,7 +209,7 @@ void Shop::update() {
 
 void Shop::updateShopInfo() {
 	for (int i = 0; i < m_menu.getSize(); i++) {
-		bool disable = RARITIE_LEVELS.at(SHOP_RARITIES[i]) > (int)round(m_info->playerState.buff.shop.apply(1));
+		bool disable = RARITIE_LEVELS.at(SHOP_RARITIES[i]) > (int)round(m_info->playerState.buff.apply<BuffType::Shop>(1));
 		if (!disable)
 			if (m_shops.at(SHOP_RARITIES[i]).update())
 				m_updated = false;
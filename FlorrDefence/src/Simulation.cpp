@@ -0,0 +1,86 @@
+#include "Simulation.hpp"
+#include "Profiler.hpp"
+#include "Record.hpp"
+
+#include <iostream>
+#include <fstream>
+#include <format>
+
+float Simulation::Report::getSpeed() const {
+	if (wall <= sf::Time::Zero)
+		return 0.f;
+	return simulated.asSeconds() / wall.asSeconds();
+}
+
+Simulation::Simulation()
+	: m_map(&m_info) {}
+
+bool Simulation::load(const std::filesystem::path& path) {
+	std::ifstream ifs(path, std::ios::binary);
+
+	if (!ifs.is_open()) {
+		std::cerr << std::format("Record '{}' not found.", path.string()) << std::endl;
+		return false;
+	}
+
+	try {
+		RecordSnapshot record = Record::parse(ifs);
+		RecordJournal::replay(record, path);
+
+		Record::restore(m_info, m_map, record);
+		applyTalents(record.talentNodes);
+
+		return true;
+	}
+	catch (const std::exception& e) {
+		std::cerr << "Failed to load game record: " << e.what() << std::endl;
+		return false;
+	}
+}
+
+void Simulation::start() {
+	m_map.getMapInfo().tick();  // init buff to prevent problems
+	m_simulated = sf::Time::Zero;
+}
+
+void Simulation::step(sf::Time dt) {
+	m_info.update(dt);
+
+	if (!m_info.playerState.isAlive())
+		return;
+
+	m_map.simulate();
+	m_simulated += dt;
+	Profiler::endFrame();
+}
+
+Simulation::Report Simulation::run(sf::Time duration, sf::Time dt) {
+	Report report;
+	sf::Clock clock;
+
+	sf::Time begin = m_simulated;
+	sf::Time end = m_simulated + duration;
+	while (m_simulated < end && m_info.playerState.isAlive()) {
+		step(dt);
+		report.frames++;
+	}
+
+	report.simulated = m_simulated - begin;
+	report.wall = clock.getElapsedTime();
+	return report;
+}
+
+void Simulation::applyTalents(const std::vector<int>& nodes) {
+	// Same rule as Talent::buyTalent, without the talent tree UI
+	std::unordered_map<std::string, int> maxRarity;
+
+	for (int id : nodes) {
+		const TalentAttribs& attribs = TALENT_ATTRIBS.at(id);
+		int rarity = RARITIE_LEVELS.at(attribs.rarity);
+
+		if (!maxRarity.contains(attribs.buff_type) || maxRarity[attribs.buff_type] < rarity) {
+			m_info.playerState.talentBuff.set(stringToBuffType(attribs.buff_type), attribs.buff_value);
+			maxRarity[attribs.buff_type] = rarity;
+		}
+	}
+}
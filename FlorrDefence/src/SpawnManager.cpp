@@ -5,12 +5,12 @@
 #include <nlohmann/json.hpp>
 
 #include "Mob.hpp"
+#include "Tools.hpp"
 
 SpawnManager::SpawnManager(SharedInfo* info)
     : m_info(info)
 {
-    std::random_device rd;
-    m_rng.seed(rd());
+    m_rng.seed(globalRNG()());
     load();
 }
 
@@ -93,11 +93,11 @@ const MobTypeEntry* SpawnManager::chooseMobType(const Stage& s) {
     return &s.mob_types.front();
 }
 
-void SpawnManager::update(std::list<std::unique_ptr<Mob>>& mobList) {
+void SpawnManager::update(MobSlots& mobList) {
     m_spawnTimer += m_info->dt;
     m_globalTimer += m_info->dt;
 
-    if (mobList.size() >= m_maxMob) return;
+    if (!m_enabled || mobList.size() >= m_maxMob) return;
     if (m_spawnTimer.asSeconds() < m_nextInterval) return;
     m_spawnTimer = sf::Time::Zero;
 
@@ -119,7 +119,7 @@ void SpawnManager::update(std::list<std::unique_ptr<Mob>>& mobList) {
 double SpawnManager::computeNextInterval(const Stage& s, int level) {
     double t = m_globalTimer.asSeconds();
     double raw = s.base_interval;
-    double rate = m_info->playerState.buff.mob_spawn_rate.apply(1.f);
+    double rate = m_info->playerState.buff.apply<BuffType::MobSpawnRate>(1.f);
 
     // Apply linear decrease per level (scale_per_level usually negative)
     int levelOffset = level - s.min_level;
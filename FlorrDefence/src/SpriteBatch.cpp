@@ -0,0 +1,52 @@
+#include "SpriteBatch.hpp"
+#include <cmath>
+#include <algorithm>
+
+void SpriteBatch::begin(sf::RenderTarget& target, sf::RenderStates states) {
+    m_target = &target;
+    m_states = states;
+    m_texture = nullptr;
+    m_vertices.clear();
+}
+
+void SpriteBatch::add(const sf::Sprite& sprite, float brightness) {
+    const sf::Texture* texture = &sprite.getTexture();
+    if (texture != m_texture)
+        flush();
+    m_texture = texture;
+
+    const sf::Transform& transform = sprite.getTransform();
+    sf::FloatRect rect(sprite.getTextureRect());
+    sf::Color color = sprite.getColor();
+
+    sf::Vector2f size(std::abs(rect.size.x), std::abs(rect.size.y));
+    float brightnessOffset = std::round(std::clamp(brightness, 0.f, 1.f) * 255.f) * brightnessStride;
+    sf::Vector2f texLeftTop = rect.position + sf::Vector2f(brightnessOffset, 0.f);
+    sf::Vector2f texRightBottom = texLeftTop + rect.size;
+
+    sf::Vertex leftTop{ transform.transformPoint({ 0.f, 0.f }), color, texLeftTop };
+    sf::Vertex rightTop{ transform.transformPoint({ size.x, 0.f }), color, { texRightBottom.x, texLeftTop.y } };
+    sf::Vertex leftBottom{ transform.transformPoint({ 0.f, size.y }), color, { texLeftTop.x, texRightBottom.y } };
+    sf::Vertex rightBottom{ transform.transformPoint(size), color, texRightBottom };
+
+    // Two triangles per quad
+    m_vertices.append(leftTop);
+    m_vertices.append(rightTop);
+    m_vertices.append(leftBottom);
+    m_vertices.append(leftBottom);
+    m_vertices.append(rightTop);
+    m_vertices.append(rightBottom);
+
+    m_stats.sprites++;
+}
+
+void SpriteBatch::flush() {
+    if (m_vertices.getVertexCount() == 0)
+        return;
+
+    sf::RenderStates states = m_states;
+    states.texture = m_texture;
+    m_target->draw(m_vertices, states);
+    m_vertices.clear();
+    m_stats.drawCalls++;
+}
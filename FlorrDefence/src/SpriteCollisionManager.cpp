@@ -1,47 +1,119 @@
 #include "SpriteCollisionManager.hpp"
 #include "AssetManager.hpp"
+#include <algorithm>
+#include <cmath>
+#include <bit>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define FLORR_SSE2
+#include <emmintrin.h>
+#endif
+
+// True if any bit is set in both rows
+static bool anyOverlap(const uint64_t* a, const uint64_t* b, size_t words) {
+    size_t i = 0;
+
+#if defined(__AVX2__)
+    for (; i + 4 <= words; i += 4) {
+        __m256i va = _mm256_loadu_si256((const __m256i*)(a + i));
+        __m256i vb = _mm256_loadu_si256((const __m256i*)(b + i));
+        if (!_mm256_testz_si256(va, vb))
+            return true;
+    }
+#elif defined(FLORR_SSE2)
+    for (; i + 2 <= words; i += 2) {
+        __m128i va = _mm_loadu_si128((const __m128i*)(a + i));
+        __m128i vb = _mm_loadu_si128((const __m128i*)(b + i));
+        __m128i both = _mm_and_si128(va, vb);
+        if (_mm_movemask_epi8(_mm_cmpeq_epi8(both, _mm_setzero_si128())) != 0xFFFF)
+            return true;
+    }
+#endif
+
+    for (; i < words; i++)
+        if (a[i] & b[i])
+            return true;
+
+    return false;
+}
+
+BitMask::BitMask(unsigned width, unsigned height)
+    : width(width), height(height), wordsPerRow((width + 63) / 64),
+      words(size_t(wordsPerRow) * height, 0) {}
 
 void SpriteCollisionManager::load() {
     const TexEntry& mobs = AssetManager::getEntry().get("mobs");
     for (const auto& [_, sub] : mobs.subs)
         if (sub->isTexture)
-            getInstance().addTexture(*sub->tex);
+            getInstance().addRegion(sub->region);
 
     const TexEntry& petals = AssetManager::getEntry().get("petals");
     for (const auto& [_, sub] : petals.subs)
         if (sub->isTexture)
-            getInstance().addTexture(*sub->tex);
+            getInstance().addRegion(sub->region);
 }
 
-sf::FloatRect SpriteCollisionManager::getTrimmedBounds(const sf::Texture& texture) {
-    return getInstance()._getTrimmedBounds(texture);
+sf::FloatRect SpriteCollisionManager::getTrimmedBounds(const TexRegion& region) {
+    return getInstance()._getTrimmedBounds(region);
 }
 
 sf::FloatRect SpriteCollisionManager::getTrimmedBounds(const sf::Sprite& sprite) {
-    return sprite.getTransform().transformRect(getInstance()._getTrimmedBounds(sprite.getTexture()));
+    return sprite.getTransform().transformRect(getInstance()._getTrimmedBounds({ &sprite.getTexture(), sprite.getTextureRect() }));
 }
 
 bool SpriteCollisionManager::isCollide(const sf::Sprite& a, const sf::Sprite& b) {
     return getInstance()._isCollide(a, b);
 }
 
+size_t SpriteCollisionManager::getMaskMemory() {
+    size_t total = 0;
+    for (const auto& [_, mask] : getInstance().m_alphaMasks)
+        total += mask.getMemory();
+    return total;
+}
+
 SpriteCollisionManager& SpriteCollisionManager::getInstance() {
     static SpriteCollisionManager instance;
     return instance;
 }
 
-sf::FloatRect SpriteCollisionManager::_getTrimmedBounds(const sf::Texture& texture) {
-    if (!m_trimmedBounds.contains(&texture))
-        addTexture(texture);
-    return m_trimmedBounds.at(&texture);
+sf::FloatRect SpriteCollisionManager::_getTrimmedBounds(const TexRegion& region) {
+    if (!m_trimmedBounds.contains(region))
+        addRegion(region);
+    return m_trimmedBounds.at(region);
 }
 
-const std::vector<uint8_t>& SpriteCollisionManager::_getAlphaMask(const sf::Texture& texture) {
+const BitMask& SpriteCollisionManager::_getAlphaMask(const sf::Texture& texture) {
     if (!m_alphaMasks.contains(&texture))
         addTexture(texture);
     return m_alphaMasks.at(&texture);
 }
 
+// Only translated, no rotation or scale. Every texel then lies on a whole texel of the other sprite.
+static bool isTranslation(const sf::Transform& transform) {
+    const float* m = transform.getMatrix();
+    return m[0] == 1.f && m[1] == 0.f && m[4] == 0.f && m[5] == 1.f;
+}
+
+// World pixels covered by one texel
+static float getTexelArea(const sf::Transform& inverse) {
+    const float* m = inverse.getMatrix();
+    return 1.f / std::abs(m[0] * m[5] - m[1] * m[4]);
+}
+
+// Bits [start, start + 64) of a mask row, zero past its end
+static uint64_t getBits(const uint64_t* row, unsigned wordsPerRow, unsigned start) {
+    const unsigned word = start >> 6;
+    const unsigned shift = start & 63;
+
+    uint64_t bits = word < wordsPerRow ? row[word] >> shift : 0;
+    if (shift != 0 && word + 1 < wordsPerRow)
+        bits |= row[word + 1] << (64 - shift);
+    return bits;
+}
+
 bool SpriteCollisionManager::_isCollide(const sf::Sprite& a, const sf::Sprite& b) {
     const sf::Texture* texA = &a.getTexture();
     const sf::Texture* texB = &b.getTexture();
@@ -49,12 +121,6 @@ bool SpriteCollisionManager::_isCollide(const sf::Sprite& a, const sf::Sprite& b
     const auto& maskA = _getAlphaMask(*texA);
     const auto& maskB = _getAlphaMask(*texB);
 
-    const auto sizeA = texA->getSize();
-    const auto sizeB = texB->getSize();
-
-    const int wA = (int)sizeA.x, hA = (int)sizeA.y;
-    const int wB = (int)sizeB.x, hB = (int)sizeB.y;
-
     const auto subA = a.getTextureRect();
     const auto subB = b.getTextureRect();
 
@@ -63,9 +129,6 @@ bool SpriteCollisionManager::_isCollide(const sf::Sprite& a, const sf::Sprite& b
 
     const sf::FloatRect r = *inter;
 
-    const int stepX = std::clamp((int)(r.size.x / 8.f) - 1, 1, 10);
-    const int stepY = std::clamp((int)(r.size.y / 8.f) - 1, 1, 10);
-
     const auto& invA = a.getInverseTransform();
     const auto& invB = b.getInverseTransform();
 
@@ -74,42 +137,153 @@ bool SpriteCollisionManager::_isCollide(const sf::Sprite& a, const sf::Sprite& b
     const int ex = (int)(r.position.x + r.size.x);
     const int ey = (int)(r.position.y + r.size.y);
 
-    const sf::Vector2f origin((float)sx + 0.5f, (float)sy + 0.5f);
+    if (isTranslation(invA) && isTranslation(invB))
+        return isCollideTranslated(maskA, subA, invA, maskB, subB, invB, { { sx, sy }, { ex - sx, ey - sy } });
 
-    sf::Vector2f rowA = invA.transformPoint(origin);
-    sf::Vector2f rowB = invB.transformPoint(origin);
-
-    const sf::Vector2f dxA = invA.transformPoint({ origin.x + (float)stepX,origin.y }) - rowA;
-    const sf::Vector2f dyA = invA.transformPoint({ origin.x,origin.y + (float)stepY }) - rowA;
-
-    const sf::Vector2f dxB = invB.transformPoint({ origin.x + (float)stepX,origin.y }) - rowB;
-    const sf::Vector2f dyB = invB.transformPoint({ origin.x,origin.y + (float)stepY }) - rowB;
-
-    for (int y = sy; y < ey; y += stepY) {
-        sf::Vector2f localA = rowA;
-        sf::Vector2f localB = rowB;
-
-        for (int x = sx; x < ex; x += stepX) {
+    // Resampled into the frame of the sprite with the larger texels, fewer rows and words to go through
+    const sf::FloatRect area({ (float)sx, (float)sy }, { (float)(ex - sx), (float)(ey - sy) });
+    if (getTexelArea(invB) > getTexelArea(invA))
+        return isCollideResampled(b, maskB, a, maskA, area);
+    return isCollideResampled(a, maskA, b, maskB, area);
+}
 
-            const int xA = (int)localA.x + subA.position.x;
-            const int yA = (int)localA.y + subA.position.y;
+bool SpriteCollisionManager::isCollideResampled(const sf::Sprite& a, const BitMask& maskA,
+                                                const sf::Sprite& b, const BitMask& maskB, sf::FloatRect area) {
+    const auto subA = a.getTextureRect();
+    const auto subB = b.getTextureRect();
 
-            const int xB = (int)localB.x + subB.position.x;
-            const int yB = (int)localB.y + subB.position.y;
+    // Texels of A under the area, within its trimmed bounds
+    const sf::FloatRect localArea = a.getInverseTransform().transformRect(area);
+    const sf::FloatRect trimA = _getTrimmedBounds({ &a.getTexture(), subA });
+    const sf::FloatRect trimB = _getTrimmedBounds({ &b.getTexture(), subB });
+
+    const int x0 = std::max((int)std::floor(localArea.position.x), (int)trimA.position.x);
+    const int y0 = std::max((int)std::floor(localArea.position.y), (int)trimA.position.y);
+    const int x1 = std::min((int)std::ceil(localArea.position.x + localArea.size.x), (int)(trimA.position.x + trimA.size.x));
+    const int y1 = std::min((int)std::ceil(localArea.position.y + localArea.size.y), (int)(trimA.position.y + trimA.size.y));
+    if (x0 >= x1 || y0 >= y1)
+        return false;
+
+    // Texel centers of A in the texels of B, one step of dx per texel along a row of A
+    const sf::Transform toB = b.getInverseTransform() * a.getTransform();
+    const sf::Vector2f origin = toB.transformPoint({ 0.f, 0.f });
+    const sf::Vector2f dx = toB.transformPoint({ 1.f, 0.f }) - origin;
+    const sf::Vector2f dy = toB.transformPoint({ 0.f, 1.f }) - origin;
+
+    // Texels k in [lo, hi) of a row starting at start that land on the trimmed bounds of B
+    auto clip = [&](sf::Vector2f start, float& lo, float& hi) {
+        auto clipAxis = [&](float p, float d, float min, float max) {
+            if (d == 0.f) {
+                if (p < min || p >= max)
+                    hi = -1.f;
+                return;
+            }
+            float t0 = (min - p) / d;
+            float t1 = (max - p) / d;
+            if (t0 > t1)
+                std::swap(t0, t1);
+            lo = std::max(lo, t0);
+            hi = std::min(hi, t1);
+        };
+        clipAxis(start.x, dx.x, trimB.position.x, trimB.position.x + trimB.size.x);
+        clipAxis(start.y, dx.y, trimB.position.y, trimB.position.y + trimB.size.y);
+    };
+
+    // Rows from the middle out, overlapping sprites usually meet there first
+    const int rows = y1 - y0;
+    for (int n = 0; n < rows; n++) {
+        const int y = y0 + rows / 2 + ((n & 1) ? -(n + 1) / 2 : n / 2);
+        const sf::Vector2f start = origin + dx * ((float)x0 + 0.5f) + dy * ((float)y + 0.5f);
+
+        float lo = 0.f, hi = (float)(x1 - x0);
+        clip(start, lo, hi);
+        const int k0 = std::max(0, (int)std::ceil(lo));
+        const int k1 = std::min(x1 - x0, (int)std::floor(hi) + 1);
+        if (k0 >= k1)
+            continue;
+
+        const uint64_t* row = &maskA.words[size_t(y + subA.position.y) * maskA.wordsPerRow];
+
+        for (int word = k0; word < k1; word += 64) {
+            // A's own texels, 64 at a time; B is only resampled under the ones set
+            uint64_t bitsA = getBits(row, maskA.wordsPerRow, unsigned(x0 + subA.position.x + word));
+            if (k1 - word < 64)
+                bitsA &= (uint64_t{ 1 } << (k1 - word)) - 1;
+            if (bitsA == 0)
+                continue;
+
+            const int first = std::countr_zero(bitsA);
+            const int last = 63 - std::countl_zero(bitsA);
+
+            // Samples outside the sub-rect are empty, they may belong to a neighbour on the atlas page
+            sf::Vector2f local = start + dx * (float)(word + first);
+            uint64_t bitsB = 0;
+            for (int k = first; k <= last; k++, local += dx) {
+                if (local.x < 0.f || local.y < 0.f)
+                    continue;
+
+                const unsigned xB = (unsigned)local.x;
+                const unsigned yB = (unsigned)local.y;
+                if (xB < (unsigned)subB.size.x && yB < (unsigned)subB.size.y &&
+                    maskB.test(xB + subB.position.x, yB + subB.position.y))
+                    bitsB |= uint64_t{ 1 } << k;
+            }
 
-            if ((unsigned)xA < sizeA.x && (unsigned)yA < sizeA.y &&
-                (unsigned)xB < sizeB.x && (unsigned)yB < sizeB.y) {
+            if (bitsA & bitsB)
+                return true;
+        }
+    }
 
-                if (maskA[yA * wA + xA] && maskB[yB * wB + xB])
-                    return true;
-            }
+    return false;
+}
 
-            localA += dxA;
-            localB += dxB;
+bool SpriteCollisionManager::isCollideTranslated(const BitMask& maskA, sf::IntRect subA, const sf::Transform& invA,
+                                                 const BitMask& maskB, sf::IntRect subB, const sf::Transform& invB,
+                                                 sf::IntRect area) {
+    // Pixel x lies on texel x + offset of a sprite, measured at the pixel center like the sampled test
+    auto getOffset = [](const sf::Transform& inv) {
+        const float* m = inv.getMatrix();
+        return sf::Vector2i((int)std::floor(0.5f + m[12]), (int)std::floor(0.5f + m[13]));
+    };
+    const sf::Vector2i offsetA = getOffset(invA);
+    const sf::Vector2i offsetB = getOffset(invB);
+
+    // Pixels on both sub-rects, texels of a neighbour on the atlas page are never read
+    const int x0 = std::max({ area.position.x, -offsetA.x, -offsetB.x });
+    const int y0 = std::max({ area.position.y, -offsetA.y, -offsetB.y });
+    const int x1 = std::min({ area.position.x + area.size.x, subA.size.x - offsetA.x, subB.size.x - offsetB.x });
+    const int y1 = std::min({ area.position.y + area.size.y, subA.size.y - offsetA.y, subB.size.y - offsetB.y });
+    if (x0 >= x1 || y0 >= y1)
+        return false;
+
+    // Every texel is tested, each row of both masks is shifted into place a word at a time
+    const int width = x1 - x0;
+    const size_t words = (width + 63) / 64;
+    m_rowA.resize(words);
+    m_rowB.resize(words);
+
+    auto extract = [&](std::vector<uint64_t>& row, const BitMask& mask, sf::IntRect sub, sf::Vector2i offset, int y) {
+        const uint64_t* source = &mask.words[size_t(y + offset.y + sub.position.y) * mask.wordsPerRow];
+        const unsigned start = unsigned(x0 + offset.x + sub.position.x);
+        bool any = false;
+
+        for (size_t i = 0; i < words; i++) {
+            row[i] = getBits(source, mask.wordsPerRow, start + unsigned(i * 64));
+            any |= row[i] != 0;
         }
 
-        rowA += dyA;
-        rowB += dyB;
+        // Past the right edge of the area
+        if (width % 64 != 0)
+            row[words - 1] &= (uint64_t{ 1 } << (width % 64)) - 1;
+        return any;
+    };
+
+    for (int y = y0; y < y1; y++) {
+        // B is only extracted where A has something on this row
+        if (extract(m_rowA, maskA, subA, offsetA, y) &&
+            extract(m_rowB, maskB, subB, offsetB, y) &&
+            anyOverlap(m_rowA.data(), m_rowB.data(), words))
+            return true;
     }
 
     return false;
@@ -120,14 +294,29 @@ void SpriteCollisionManager::addTexture(const sf::Texture& texture) {
     unsigned int w = img.getSize().x;
     unsigned int h = img.getSize().y;
 
-    // Trimmed bounds
-    unsigned int minX = w, minY = h;
-    unsigned int maxX = 0, maxY = 0;
+    BitMask alphaMask(w, h);
+    for (unsigned y = 0; y < h; y++) {
+        for (unsigned x = 0; x < w; x++) {
+            if (img.getPixel({ x, y }).a > alphaThreshold)
+                alphaMask.set(x, y);
+        }
+    }
+
+    m_alphaMasks[&texture] = std::move(alphaMask);
+}
+
+void SpriteCollisionManager::addRegion(const TexRegion& region) {
+    const BitMask& mask = _getAlphaMask(region.getTexture());
+    const sf::IntRect& rect = region.rect;
+
+    // Trimmed bounds, relative to the region
+    int minX = rect.size.x, minY = rect.size.y;
+    int maxX = 0, maxY = 0;
     bool found = false;
 
-    for (unsigned int y = 0; y < h; y++) {
-        for (unsigned int x = 0; x < w; x++) {
-            if (img.getPixel({ x, y }).a > alphaThreshold) {
+    for (int y = 0; y < rect.size.y; y++) {
+        for (int x = 0; x < rect.size.x; x++) {
+            if (mask.test(rect.position.x + x, rect.position.y + y)) {
                 if (!found) {
                     minX = maxX = x;
                     minY = maxY = y;
@@ -143,18 +332,6 @@ void SpriteCollisionManager::addTexture(const sf::Texture& texture) {
         }
     }
 
-    sf::FloatRect bounds = !found ? sf::FloatRect({ 0, 0 }, { 0, 0 })
+    m_trimmedBounds[region] = !found ? sf::FloatRect({ 0, 0 }, { 0, 0 })
         : sf::FloatRect({ float(minX), float(minY) }, { float(maxX - minX + 1), float(maxY - minY + 1) });
-
-    m_trimmedBounds[&texture] = bounds;
-
-    // Alpha mask
-    std::vector<uint8_t> alphaMask(w * h);
-    for (unsigned y = 0; y < h; y++) {
-        for (unsigned x = 0; x < w; x++) {
-            alphaMask[y * w + x] = img.getPixel({ x, y }).a > alphaThreshold ? 1 : 0;
-        }
-    }
-
-    m_alphaMasks[&texture] = std::move(alphaMask);
 }
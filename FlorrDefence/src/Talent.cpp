@@ -252,8 +252,7 @@ void Talent::buyTalent(int id, bool free) {
 
 		// Only update max rarity
 		if (!m_maxRarity.contains(type) || m_maxRarity[type] < rarity) {
-			Buff& buff = m_info->playerState.talentBuff.get(type);
-			buff.set(m_nodes[i].getAttribs().buff_value);
+			m_info->playerState.talentBuff.set(stringToBuffType(type), m_nodes[i].getAttribs().buff_value);
 			m_maxRarity[type] = rarity;
 		}
 
@@ -0,0 +1,75 @@
+#include "TextureAtlas.hpp"
+#include <algorithm>
+#include <numeric>
+#include <stdexcept>
+#include <format>
+
+size_t TextureAtlas::add(sf::Image image) {
+    sf::Vector2u size = image.getSize();
+    if (size.x + padding > pageSize || size.y + padding > pageSize)
+        throw std::runtime_error(std::format("Image of {}x{} does not fit into an atlas page", size.x, size.y));
+
+    m_images.push_back(std::move(image));
+    m_regions.push_back({});
+    return m_images.size() - 1;
+}
+
+void TextureAtlas::build() {
+    // Shelf packing, tallest first so each shelf wastes little height
+    std::vector<size_t> order(m_images.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+        return m_images[a].getSize().y > m_images[b].getSize().y;
+    });
+
+    std::vector<size_t> pageOf(m_images.size());
+    std::vector<unsigned> pageHeights;
+    unsigned x = 0, y = 0, shelfHeight = 0;
+
+    for (size_t id : order) {
+        sf::Vector2u size = m_images[id].getSize();
+
+        if (pageHeights.empty() || x + size.x + padding > pageSize) {
+            // Next shelf, or next page once the shelf would not fit
+            y += shelfHeight;
+            x = 0;
+            shelfHeight = 0;
+
+            if (pageHeights.empty() || y + size.y + padding > pageSize) {
+                pageHeights.push_back(0);
+                y = 0;
+            }
+        }
+
+        pageOf[id] = pageHeights.size() - 1;
+        m_regions[id].rect = sf::IntRect({ (int)x, (int)y }, { (int)size.x, (int)size.y });
+
+        x += size.x + padding;
+        shelfHeight = std::max(shelfHeight, size.y + padding);
+        pageHeights.back() = std::max(pageHeights.back(), y + shelfHeight);
+    }
+
+    // Pages are only as tall as their content
+    std::vector<sf::Image> pageImages;
+    for (unsigned height : pageHeights)
+        pageImages.emplace_back(sf::Vector2u(pageSize, height), sf::Color::Transparent);
+
+    for (size_t id = 0; id < m_images.size(); id++) {
+        sf::Vector2u dest(m_regions[id].rect.position);
+        if (!pageImages[pageOf[id]].copy(m_images[id], dest))
+            throw std::runtime_error("Texture atlas copy failure");
+    }
+
+    m_pages.clear();
+    for (const sf::Image& image : pageImages) {
+        auto page = std::make_unique<sf::Texture>();
+        if (!page->loadFromImage(image))
+            throw std::runtime_error("Texture atlas page load failure");
+        m_pages.push_back(std::move(page));
+    }
+
+    for (size_t id = 0; id < m_images.size(); id++)
+        m_regions[id].texture = m_pages[pageOf[id]].get();
+
+    m_images.clear();
+}
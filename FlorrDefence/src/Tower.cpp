@@ -50,7 +50,7 @@ std::unique_ptr<Tower> Tower::create(SharedInfo* info, const CardInfo& card, sf:
 }
 
 Tower::Tower(SharedInfo* info, const CardInfo& card)
-	: m_info(info), m_attribs(TOWER_ATTRIBS[card.type][card.rarity]) {
+	: m_info(info), m_attribs(TOWER_ATTRIBS[card.type][card.rarity]), m_stats(&info->effectiveStats.getEntry(card)) {
 	m_card.setCard(card);
 
     m_info->counter.tower[getCard()]++;
@@ -60,12 +60,27 @@ Tower::~Tower() {
     m_info->counter.tower[getCard()]--;
 }
 
+void Tower::cycleTargetMode() {
+    switch (m_targetMode) {
+    case TargetMode::Nearest: m_targetMode = TargetMode::First; break;
+    case TargetMode::First: m_targetMode = TargetMode::Last; break;
+    case TargetMode::Last: m_targetMode = TargetMode::Strongest; break;
+    case TargetMode::Strongest: m_targetMode = TargetMode::Nearest; break;
+    }
+}
+
 void Tower::draw(sf::RenderTarget& target, sf::RenderStates states) const {
 	states.transform *= getTransform();
 
 	target.draw(m_card, states);
 }
 
+void Tower::drawCardPart(TowerCard::Part part, sf::RenderTarget& target, sf::RenderStates states) const {
+	states.transform *= getTransform();
+
+	m_card.drawPart(part, target, states);
+}
+
 // ShootTower
 ShootTower::ShootTower(SharedInfo* info, const CardInfo& card)
 	: Tower(info, card) {
@@ -75,39 +90,36 @@ ShootTower::ShootTower(SharedInfo* info, const CardInfo& card)
 void ShootTower::update() {
     m_reloadTimer += m_info->dt;
     float elapsedTime = m_reloadTimer.asSeconds();
-    m_card.setReload(std::min(1.0f, (elapsedTime / getBuffedAttrib("reload"))), false);
+    m_card.setReload(std::min(1.0f, (elapsedTime / getStats().reload)), false);
 }
 
-void ShootTower::tick(std::list<std::unique_ptr<Petal>>& petals, const std::list<std::unique_ptr<Mob>>& mobs) {
-	if (m_reloadTimer.asSeconds() > getBuffedAttrib("reload")) {
-        std::optional nearestMob = getNearestMob(mobs);
-        if (nearestMob) {
-            petals.push_back(ShootPetal::create(m_info, m_card.getCard(), getPosition(), *nearestMob));
+void ShootTower::tick(PetalSlots& petals, const MobSlots& mobs) {
+	if (m_reloadTimer.asSeconds() > getStats().reload) {
+        std::optional target = getTarget();
+        if (target) {
+            petals.push_back(ShootPetal::create(m_info, m_card.getCard(), getPosition(), mobs, *target));
             m_reloadTimer = sf::Time::Zero;
         }
 	}
 }
 
-std::optional<std::list<std::unique_ptr<Mob>>::const_iterator> ShootTower::getNearestMob(const std::list<std::unique_ptr<Mob>>& mobs) const {
-    float range = m_info->playerState.buff.reach.apply(getAttrib("range") * MapInfo::squareSize.x);
-    float rangeSquared = range * range;
-    auto towerPos = getPosition();
-
-    std::optional<std::list<std::unique_ptr<Mob>>::const_iterator> nearestMob;
-    float nearestDistSquared = std::numeric_limits<float>::max();
-
-    for (auto it = mobs.begin(); it != mobs.end(); it++) {
-        if (it->get()->isUnderground()) continue;  // Cannot target mobs underground
-
-        float distSquared = getDistanceSquare(towerPos, it->get()->getPosition());
+std::optional<MobHandle> ShootTower::getTarget() const {
+    queryTargets(1, m_targets);
+    if (m_targets.empty())
+        return std::nullopt;
+    return m_targets.front();
+}
 
-        if (distSquared <= rangeSquared && distSquared < nearestDistSquared) {
-            nearestDistSquared = distSquared;
-            nearestMob = it;
-        }
+void ShootTower::queryTargets(int count, std::vector<MobHandle>& result) const {
+    float range = getStats().range;
+    if (m_targetMode == TargetMode::Nearest) {
+        m_info->mobQuery.kNearest(getPosition(), range, count, result);
+        return;
     }
 
-    return nearestMob;
+    // Only mobs on the parts of the path within range are scanned
+    const auto& intervals = m_coverage.get(getPosition(), range);
+    m_info->pathIndex.query(intervals, getPosition(), range, m_targetMode, count, result);
 }
 
 // DefenceTower
@@ -121,7 +133,7 @@ void DefenceTower::update() {
         m_reloadTimer = sf::Time::Zero;
         if (defence->getCard() == getCard()) {
             int hp = defence->getHp();
-            int totalHp = int(getAttrib("hp"));
+            int totalHp = int(getAttrib(Attrib::Hp));
             m_card.setReload(float(hp) / totalHp, true);
         }
         else {
@@ -131,12 +143,12 @@ void DefenceTower::update() {
     else {
         m_reloadTimer += m_info->dt;
         float elapsedTime = m_reloadTimer.asSeconds();
-        m_card.setReload(std::min(1.0f, (elapsedTime / getBuffedAttrib("reload"))), false);
+        m_card.setReload(std::min(1.0f, (elapsedTime / getStats().reload)), false);
     }
 }
 
-void DefenceTower::tick(std::list<std::unique_ptr<Petal>>& petals, const std::list<std::unique_ptr<Mob>>& mobs) {
-    if (m_reloadTimer.asSeconds() > getBuffedAttrib("reload")) {
+void DefenceTower::tick(PetalSlots& petals, const MobSlots& mobs) {
+    if (m_reloadTimer.asSeconds() > getStats().reload) {
         if (!m_info->defencePetalMap[m_square.x][m_square.y]) {
             petals.push_back(DefencePetal::create(m_info, m_card.getCard(), m_square));
             m_reloadTimer = sf::Time::Zero;
@@ -156,12 +168,12 @@ void SummonTower::update() {
     else {
         m_reloadTimer += m_info->dt;
         float elapsedTime = m_reloadTimer.asSeconds();
-        m_card.setReload(std::min(1.0f, (elapsedTime / getBuffedAttrib("reload"))), false);
+        m_card.setReload(std::min(1.0f, (elapsedTime / getStats().reload)), false);
     }
 }
 
-void SummonTower::tick(std::list<std::unique_ptr<Petal>>& petals, const std::list<std::unique_ptr<Mob>>& mobs) {
-    if (m_reloadTimer.asSeconds() > getBuffedAttrib("reload")) {
+void SummonTower::tick(PetalSlots& petals, const MobSlots& mobs) {
+    if (m_reloadTimer.asSeconds() > getStats().reload) {
         if (ableToSummon()) {
             petals.push_back(MobPetal::create(m_info, getCard()));
             m_reloadTimer = sf::Time::Zero;
@@ -170,7 +182,7 @@ void SummonTower::tick(std::list<std::unique_ptr<Petal>>& petals, const std::lis
 }
 
 bool SummonTower::ableToSummon() {
-    return m_info->counter.petal[getCard()] < m_info->counter.tower[getCard()] * getAttrib("copy");
+    return m_info->counter.petal[getCard()] < m_info->counter.tower[getCard()] * getStats().copy;
 }
 
 // Buff Tower
@@ -186,15 +198,6 @@ void BuffTower::update() {
         m_card.setReload(0.f, true);
 }
 
-void BuffTower::applyToBuff() {
-    for (auto [name, value] : m_attribs.attribs) {
-        if (name.find("_buff") != std::string::npos) {
-            std::string key = name.substr(0, name.size() - 5);
-            m_info->playerState.towerBuff.get(key).add(value);
-        }
-    }
-}
-
 bool BuffTower::isActive() const {
     return m_info->playerState.buffManager.find(getCard(), m_square);
 }
@@ -204,58 +207,15 @@ MultiShotTower::MultiShotTower(SharedInfo* info, const CardInfo& card)
     : ShootTower(info, card) {
 }
 
-std::vector<std::list<std::unique_ptr<Mob>>::const_iterator>
-MultiShotTower::getTargets(const std::list<std::unique_ptr<Mob>>& mobs) const {
-    const float range = m_info->playerState.buff.reach.apply(getAttrib("range") * MapInfo::squareSize.x);
-    const float rangeSq = range * range;
-    const int maxTargets = (int)(getAttrib("copy"));
-    auto towerPos = getPosition();
-
-    std::vector<std::pair<
-        std::list<std::unique_ptr<Mob>>::const_iterator,
-        float>> best;
-
-    for (auto it = mobs.begin(); it != mobs.end(); it++) {
-        if (it->get()->isUnderground()) continue;  // Do not target mobs underground
-
-        float d2 = getDistanceSquare(towerPos, it->get()->getPosition());
-        if (d2 > rangeSq) continue;
-
-        if (best.size() < maxTargets) {
-            best.emplace_back(it, d2);
-            int i = (int)best.size() - 1;
-            while (i > 0 && best[i].second < best[i - 1].second) {
-                std::swap(best[i], best[i - 1]);
-                i--;
-            }
-        }
-        else if (d2 < best.back().second) {
-            int i = (int)best.size() - 1;
-            while (i > 0 && best[i - 1].second > d2) {
-                best[i] = best[i - 1];
-                i--;
-            }
-            best[i] = std::pair{ it, d2 };
-        }
-    }
-
-    std::vector<std::list<std::unique_ptr<Mob>>::const_iterator> targets;
-    targets.reserve(best.size());
-    for (auto& p : best)
-        targets.push_back(p.first);
-
-    return targets;
-}
-
-void MultiShotTower::tick(std::list<std::unique_ptr<Petal>>& petals,
-    const std::list<std::unique_ptr<Mob>>& mobs) {
-    if (m_reloadTimer.asSeconds() > getBuffedAttrib("reload")) {
-        auto targets = getTargets(mobs);
-        if (!targets.empty()) {
-            for (auto it : targets) {
+void MultiShotTower::tick(PetalSlots& petals,
+    const MobSlots& mobs) {
+    if (m_reloadTimer.asSeconds() > getStats().reload) {
+        queryTargets((int)getStats().copy, m_targets);
+        if (!m_targets.empty()) {
+            for (MobHandle target : m_targets) {
                 petals.push_back(
                     ShootPetal::create(m_info, m_card.getCard(),
-                        getPosition(), it));
+                        getPosition(), mobs, target));
             }
             m_reloadTimer = sf::Time::Zero;
         }
@@ -281,7 +241,7 @@ void WebTower::update() {
     else {
         m_reloadTimer += m_info->dt;
         float elapsedTime = m_reloadTimer.asSeconds();
-        m_card.setReload(std::min(1.0f, (elapsedTime / getBuffedAttrib("reload"))), false);
+        m_card.setReload(std::min(1.0f, (elapsedTime / getStats().reload)), false);
     }
 }
 
@@ -289,11 +249,11 @@ void WebTower::update() {
 void PollenTower::update() {
     m_reloadTimer += m_info->dt;
     float elapsedTime = m_reloadTimer.asSeconds();
-    m_card.setReload(std::min(1.0f, (elapsedTime / getBuffedAttrib("reload"))), false);
+    m_card.setReload(std::min(1.0f, (elapsedTime / getStats().reload)), false);
 }
 
-void PollenTower::tick(std::list<std::unique_ptr<Petal>>& petals, const std::list<std::unique_ptr<Mob>>& mobs) {
-    if (m_reloadTimer.asSeconds() < getBuffedAttrib("reload"))
+void PollenTower::tick(PetalSlots& petals, const MobSlots& mobs) {
+    if (m_reloadTimer.asSeconds() < getStats().reload)
         return;
     
     int index = 0;
@@ -303,7 +263,7 @@ void PollenTower::tick(std::list<std::unique_ptr<Petal>>& petals, const std::lis
 
     int left = index;
     int right = index;
-    int copyLeft = (int)getAttrib("copy");
+    int copyLeft = (int)getStats().copy;
     while (copyLeft > 0 && (left > 0 || right < PATH_SQUARES.size())) {
         if (left >= 0) {
             sf::Vector2i leftSq = PATH_SQUARES[left];
@@ -328,12 +288,12 @@ void PollenTower::tick(std::list<std::unique_ptr<Petal>>& petals, const std::lis
 // Shovel Tower (Defence Tower)
 void ShovelTower::update() {
     if (auto defence = m_info->defencePetalMap[m_square.x][m_square.y]) {
-        int rarity = RARITIE_LEVELS.at(m_card.getCard().rarity);
-        int petalRarity = RARITIE_LEVELS.at(defence->getCard().rarity);
+        int rarity = getRarityLevel(m_card.getCard().rarity);
+        int petalRarity = getRarityLevel(defence->getCard().rarity);
         if (rarity >= petalRarity) {
             m_reloadTimer += m_info->dt;
             float elapsedTime = m_reloadTimer.asSeconds();
-            m_card.setReload(std::min(1.0f, (elapsedTime / getBuffedAttrib("reload"))), false);
+            m_card.setReload(std::min(1.0f, (elapsedTime / getStats().reload)), false);
             return;
         }
     }
@@ -342,11 +302,11 @@ void ShovelTower::update() {
     m_card.setReload(0.f, true);
 }
 
-void ShovelTower::tick(std::list<std::unique_ptr<Petal>>& petals, const std::list<std::unique_ptr<Mob>>& mobs) {
-    if (m_reloadTimer.asSeconds() > getBuffedAttrib("reload")) {
+void ShovelTower::tick(PetalSlots& petals, const MobSlots& mobs) {
+    if (m_reloadTimer.asSeconds() > getStats().reload) {
         if (auto defence = m_info->defencePetalMap[m_square.x][m_square.y]) {
-            int rarity = RARITIE_LEVELS.at(m_card.getCard().rarity);
-            int petalRarity = RARITIE_LEVELS.at(defence->getCard().rarity);
+            int rarity = getRarityLevel(m_card.getCard().rarity);
+            int petalRarity = getRarityLevel(defence->getCard().rarity);
             if (rarity >= petalRarity) {
                 defence->kill();
                 int64_t coin = TOWER_ATTRIBS["shovel"].rarities[defence->getCard().rarity].coin;
@@ -362,7 +322,7 @@ void RoseTower::update() {
     if (isActive()) {
         m_reloadTimer += m_info->dt;
         float elapseTime = m_reloadTimer.asSeconds();
-        m_card.setReload(std::min(1.0f, (elapseTime / getBuffedAttrib("reload"))), false);
+        m_card.setReload(std::min(1.0f, (elapseTime / getStats().reload)), false);
     }
     else {
         m_card.setReload(0.f, true);
@@ -370,9 +330,9 @@ void RoseTower::update() {
     }
 }
 
-void RoseTower::tick(std::list<std::unique_ptr<Petal>>& petals, const std::list<std::unique_ptr<Mob>>& mobs) {
-    if (m_reloadTimer.asSeconds() > getBuffedAttrib("reload")) {
-        m_info->playerState.heal(getAttrib("heal"));
+void RoseTower::tick(PetalSlots& petals, const MobSlots& mobs) {
+    if (m_reloadTimer.asSeconds() > getStats().reload) {
+        m_info->playerState.heal(getAttrib(Attrib::Heal));
         m_reloadTimer = sf::Time::Zero;
     }
 }
@@ -382,7 +342,7 @@ void ShellTower::update() {
     if (isActive()) {
         m_reloadTimer += m_info->dt;
         float elapseTime = m_reloadTimer.asSeconds();
-        m_card.setReload(std::min(1.0f, (elapseTime / getBuffedAttrib("reload"))), false);
+        m_card.setReload(std::min(1.0f, (elapseTime / getStats().reload)), false);
     }
     else {
         m_card.setReload(0.f, true);
@@ -390,9 +350,9 @@ void ShellTower::update() {
     }
 }
 
-void ShellTower::tick(std::list<std::unique_ptr<Petal>>& petals, const std::list<std::unique_ptr<Mob>>& mobs) {
-    if (m_reloadTimer.asSeconds() > getBuffedAttrib("reload")) {
-        m_info->playerState.addShield(getAttrib("shield"));
+void ShellTower::tick(PetalSlots& petals, const MobSlots& mobs) {
+    if (m_reloadTimer.asSeconds() > getStats().reload) {
+        m_info->playerState.addShield(getAttrib(Attrib::Shield));
         m_reloadTimer = sf::Time::Zero;
     }
 }
@@ -402,7 +362,7 @@ void CoinTower::update() {
     if (isActive()) {
         m_reloadTimer += m_info->dt;
         float elapseTime = m_reloadTimer.asSeconds();
-        m_card.setReload(std::min(1.0f, (elapseTime / getBuffedAttrib("reload"))), false);
+        m_card.setReload(std::min(1.0f, (elapseTime / getStats().reload)), false);
     }
     else {
         m_card.setReload(0.f, true);
@@ -410,8 +370,8 @@ void CoinTower::update() {
     }
 }
 
-void CoinTower::tick(std::list<std::unique_ptr<Petal>>& petals, const std::list<std::unique_ptr<Mob>>& mobs) {
-    if (m_reloadTimer.asSeconds() > getBuffedAttrib("reload")) {
+void CoinTower::tick(PetalSlots& petals, const MobSlots& mobs) {
+    if (m_reloadTimer.asSeconds() > getStats().reload) {
         m_info->playerState.addCoin(m_attribs.coin);
         m_reloadTimer = sf::Time::Zero;
     }
@@ -421,11 +381,11 @@ void CoinTower::tick(std::list<std::unique_ptr<Petal>>& petals, const std::list<
 TriangleTower::TriangleTower(SharedInfo* info, const CardInfo& card, sf::Vector2i square, const MapInfo& map)
     : ShootTower(info, card), m_square(square), m_map(&map) {}
 
-void TriangleTower::tick(std::list<std::unique_ptr<Petal>>& petals, const std::list<std::unique_ptr<Mob>>& mobs) {
-    if (m_reloadTimer.asSeconds() > getBuffedAttrib("reload")) {
-        std::optional nearestMob = getNearestMob(mobs);
-        if (nearestMob) {
-            petals.push_back(std::make_unique<TrianglePetal>(m_info, m_card.getCard(), getPosition(), *nearestMob, countAdjacentSameType()));
+void TriangleTower::tick(PetalSlots& petals, const MobSlots& mobs) {
+    if (m_reloadTimer.asSeconds() > getStats().reload) {
+        std::optional target = getTarget();
+        if (target) {
+            petals.push_back(std::make_unique<TrianglePetal>(m_info, m_card.getCard(), getPosition(), mobs, *target, countAdjacentSameType()));
             m_reloadTimer = sf::Time::Zero;
         }
     }
@@ -464,8 +424,8 @@ void LaserTower::update() {
 GlassTower::GlassTower(SharedInfo* info, const CardInfo& card, sf::Vector2i square, const MapInfo& map)
     : DefenceTower(info, card, square), m_map(&map) {}
 
-void GlassTower::tick(std::list<std::unique_ptr<Petal>>& petals, const std::list<std::unique_ptr<Mob>>& mobs) {
-    if (m_reloadTimer.asSeconds() > getBuffedAttrib("reload")) {
+void GlassTower::tick(PetalSlots& petals, const MobSlots& mobs) {
+    if (m_reloadTimer.asSeconds() > getStats().reload) {
         if (!m_info->defencePetalMap[m_square.x][m_square.y]) {
             petals.push_back(std::make_unique<GlassPetal>(m_info, m_card.getCard(), m_square, *m_map));
             m_reloadTimer = sf::Time::Zero;
@@ -478,7 +438,7 @@ void YuccaTower::update() {
     if (isActive()) {
         m_reloadTimer += m_info->dt;
         float elapseTime = m_reloadTimer.asSeconds();
-        m_card.setReload(std::min(1.0f, (elapseTime / getBuffedAttrib("reload"))), false);
+        m_card.setReload(std::min(1.0f, (elapseTime / getStats().reload)), false);
     }
     else {
         m_card.setReload(0.f, true);
@@ -486,9 +446,9 @@ void YuccaTower::update() {
     }
 }
 
-void YuccaTower::tick(std::list<std::unique_ptr<Petal>>& petals, const std::list<std::unique_ptr<Mob>>& mobs) {
-    if (m_reloadTimer.asSeconds() > getBuffedAttrib("reload")) {
-        float percent = getAttrib("petal_heal");
+void YuccaTower::tick(PetalSlots& petals, const MobSlots& mobs) {
+    if (m_reloadTimer.asSeconds() > getStats().reload) {
+        float percent = getAttrib(Attrib::PetalHeal);
 
         for (std::unique_ptr<Petal>& petal : petals)
             petal->heal(percent);
@@ -520,36 +480,31 @@ void UraniumTower::update() {
     const float frequency = 0.5f;
     float t = m_pulseTimer.asSeconds() * frequency;
 
-    float maxRadius = getAttrib("radius") * MapInfo::squareSize.x;
+    float maxRadius = getAttrib(Attrib::Radius) * MapInfo::squareSize.x;
     float radius = minRadius + (maxRadius - minRadius) * (1.f + std::cos(t * 2.f * 3.14159265f)) * 0.5f;
     float scale = radius / minRadius;
 
     m_circle.setScale({ scale, scale });
 }
 
-void UraniumTower::tick(std::list<std::unique_ptr<Petal>>& petals, const std::list<std::unique_ptr<Mob>>& mobs) {
+void UraniumTower::tick(PetalSlots& petals, const MobSlots& mobs) {
     if (m_timer < TICK * 2.f)  // upadte per two ticks
         return;
     
-    float range = getAttrib("radius") * MapInfo::squareSize.x;
-    float rangeSquared = range * range;
+    float range = getAttrib(Attrib::Radius) * MapInfo::squareSize.x;
     auto towerPos = getPosition();
 
-    m_damageAcc += getBuffedAttrib("damage") * m_timer.asSeconds();
+    m_damageAcc += getStats().damage * m_timer.asSeconds();
     m_timer = sf::Time::Zero;
 
     int damage = int(m_damageAcc);
     m_damageAcc -= damage;
 
-    for (auto it = mobs.begin(); it != mobs.end(); it++) {
-        // Uranium can target mobs undergound
-        // if (it->get()->isUnderground()) continue;
-
-        float distSquared = getDistanceSquare(towerPos, it->get()->getPosition());
-
-        if (distSquared <= rangeSquared) {
-            it->get()->hit(damage, TOWER_ATTRIBS.at(getCard().type).damageType);
-        }
+    // Uranium can target mobs undergound
+    m_info->mobQuery.withinRadius(towerPos, range, m_targets, true);
+    for (MobHandle handle : m_targets) {
+        if (Mob* mob = mobs.get(handle))
+            mob->hit(damage, TOWER_ATTRIBS.at(getCard().type).damageType);
     }
 }
 
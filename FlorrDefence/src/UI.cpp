@@ -1,5 +1,6 @@
 #include "UI.hpp"
 #include "AssetManager.hpp"
+#include "Profiler.hpp"
 
 UI::UI(SharedInfo* info)
 	: m_info(info), m_shop(info), m_backpack(info), m_craft(info), m_talent(info),
@@ -68,6 +69,8 @@ void UI::updateComponents() {
 }
 
 void UI::draw(sf::RenderTarget& target, sf::RenderStates states) const {
+	PROFILE_SCOPE(ProfilePhase::UIDraw);
+
 	// Background
 	target.draw(m_background, states);
 	// Player States
@@ -5,11 +5,13 @@
 #include "Constants.hpp"
 #include "OS.hpp"
 #include "Record.hpp"
+#include "Profiler.hpp"
 
 void load() {
     loadConstants();
     AssetManager::load();
     SpriteCollisionManager::load();
+    Profiler::setEnabled(PROFILER_ENABLED);
 
 #ifdef _WIN32
     OS::showConsole(SHOW_CONSOLE);
@@ -24,7 +26,7 @@ int main() {
 
     // Init window
     sf::ContextSettings settings;
-    settings.antiAliasingLevel = 6;
+    settings.antiAliasingLevel = ANTI_ALIASING_LEVEL;
 
     sf::RenderWindow window;
     window.create(sf::VideoMode(WINDOW_INIT_SIZE), "Florr Defence", sf::Style::Default, sf::State::Windowed, settings);
@@ -52,6 +54,8 @@ int main() {
             break;
 
         case Game::Request::Quit:
+            if (Profiler::isEnabled())
+                Profiler::exportToFile(PROFILER_EXPORT_PATH);
             return 0;
 
         case Game::Request::Restart: {
@@ -73,4 +77,7 @@ int main() {
         }
         }
     }
+
+    if (Profiler::isEnabled())
+        Profiler::exportToFile(PROFILER_EXPORT_PATH);
 }
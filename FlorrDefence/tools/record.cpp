@@ -0,0 +1,153 @@
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <format>
+#include <chrono>
+#include <filesystem>
+#include <algorithm>
+#include "Record.hpp"
+#include "RecordJournal.hpp"
+#include "RecordSnapshot.hpp"
+
+// Converts records between JSON and the binary format, and compares the two on a given record.
+// A save is timed from the snapshot to the file, a load from the file to the snapshot. Capturing the
+// snapshot from the game and restoring the game from it are the same for both formats.
+// check runs journaled saves through both formats and verifies what reloading them gives.
+
+static int usage() {
+    std::cerr << "Usage: FlorrDefenceRecord convert FROM TO" << std::endl;
+    std::cerr << "       FlorrDefenceRecord bench RECORD [--iterations N]" << std::endl;
+    std::cerr << "       FlorrDefenceRecord check" << std::endl;
+    return -1;
+}
+
+static int bench(const std::filesystem::path& path, int iterations) {
+    using Clock = std::chrono::steady_clock;
+
+    std::ifstream ifs(path, std::ios::binary);
+    if (!ifs.is_open()) {
+        std::cerr << std::format("Record '{}' not found.", path.string()) << std::endl;
+        return -1;
+    }
+    RecordSnapshot record = Record::parse(ifs);
+    RecordJournal::replay(record, path);
+    record.checkpointId = 0;
+
+    std::cout << std::format("{:<8} {:>12} {:>12} {:>12}", "format", "save ms", "load ms", "size KiB") << std::endl;
+
+    for (auto [format, name] : { std::pair{ RecordFormat::Json, "json" }, std::pair{ RecordFormat::Binary, "binary" } }) {
+        std::filesystem::path out = std::filesystem::temp_directory_path()
+            / std::format("FlorrDefenceRecord{}", format == RecordFormat::Binary ? Record::binaryExtension : ".json");
+
+        Clock::time_point start = Clock::now();
+        for (int i = 0; i < iterations; i++) {
+            std::ofstream ofs(out, std::ios::binary);
+            Record::write(ofs, record, format);
+        }
+        std::chrono::duration<double, std::milli> save = Clock::now() - start;
+
+        start = Clock::now();
+        for (int i = 0; i < iterations; i++) {
+            std::ifstream in(out, std::ios::binary);
+            RecordSnapshot loaded = Record::parse(in);
+        }
+        std::chrono::duration<double, std::milli> load = Clock::now() - start;
+
+        std::cout << std::format("{:<8} {:>12.3f} {:>12.3f} {:>12.1f}", name, save.count() / iterations,
+            load.count() / iterations, std::filesystem::file_size(out) / 1024.0) << std::endl;
+        std::filesystem::remove(out);
+    }
+
+    return 0;
+}
+
+// Saves while a card is dragged out of the backpack, drops it onto the map as a tower and saves again.
+// The reloaded record must hold the tower, and the card only as many times as the backpack has it left.
+static bool checkDragDrop(const std::filesystem::path& path) {
+    std::filesystem::remove(path);
+    std::filesystem::remove(RecordJournal::getPath(path));
+
+    const CardInfo card = { "common", "basic" };
+    RecordJournal journal;
+    BackpackInfo backpack;
+    backpack.add({ card, 2 });
+
+    // Dragging takes the card out of the live backpack
+    backpack.add({ card, -1 });
+
+    RecordSnapshot dragging;
+    dragging.setBackpack(backpack, journal.needsBackpack(path, backpack.getVersion()), card);
+    journal.save(dragging, path);
+
+    // Dropping it leaves the backpack untouched
+    RecordSnapshot dropped;
+    dropped.setBackpack(backpack, journal.needsBackpack(path, backpack.getVersion()), std::nullopt);
+    dropped.towers.push_back({ { 0, 0 }, card, sf::Time::Zero, std::nullopt });
+    journal.save(dropped, path);
+
+    std::ifstream ifs(path, std::ios::binary);
+    RecordSnapshot loaded = Record::parse(ifs);
+    size_t saves = RecordJournal::replay(loaded, path);
+
+    int cards = loaded.backpack ? loaded.backpack->getCount(card) : 0;
+    bool ok = cards == 1 && loaded.towers.size() == 1;
+
+    std::cout << std::format("{:<32} {} (cards {}, towers {}, journaled saves {})", path.filename().string(),
+        ok ? "ok" : "FAILED", cards, loaded.towers.size(), saves) << std::endl;
+
+    std::filesystem::remove(path);
+    std::filesystem::remove(RecordJournal::getPath(path));
+    return ok;
+}
+
+static int check() {
+    std::filesystem::path dir = std::filesystem::temp_directory_path();
+    bool ok = true;
+    for (const std::string& extension : { std::string(".json"), Record::binaryExtension })
+        ok = checkDragDrop(dir / ("FlorrDefenceRecordCheck" + extension)) && ok;
+    return ok ? 0 : -1;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc == 2 && std::string(argv[1]) == "check") {
+        try {
+            return check();
+        }
+        catch (const std::exception& e) {
+            std::cerr << "Failed to check records: " << e.what() << std::endl;
+            return -1;
+        }
+    }
+
+    if (argc < 3)
+        return usage();
+
+    std::string command = argv[1];
+
+    if (command == "convert" && argc == 4)
+        return Record::convert(argv[2], argv[3]) ? 0 : -1;
+
+    if (command == "bench") {
+        int iterations = 20;
+        for (int i = 3; i + 1 < argc; i += 2) {
+            std::string arg = argv[i];
+            if (arg == "--iterations")
+                iterations = std::max(1, std::stoi(argv[i + 1]));
+            else {
+                std::cerr << "Unknown argument: " << arg << std::endl;
+                return -1;
+            }
+        }
+
+        try {
+            return bench(argv[2], iterations);
+        }
+        catch (const std::exception& e) {
+            std::cerr << "Failed to benchmark record: " << e.what() << std::endl;
+            return -1;
+        }
+    }
+
+    return usage();
+}